@@ -0,0 +1,149 @@
+#include "HlmsImgui.h"
+
+#include <OgreRoot.h>
+#include <OgreRenderSystem.h>
+#include <OgreRenderable.h>
+#include <OgreHlmsManager.h>
+#include <OgreTextureGpu.h>
+#include <OgreGpuProgram.h>
+#include <Vao/OgreVertexArrayObject.h>
+#include <CommandBuffer/OgreCommandBuffer.h>
+#include <CommandBuffer/OgreCbTexture.h>
+
+using namespace Ogre;
+
+static const IdString ImguiTexArray("imgui_tex_array");
+static const IdString ImguiPositionRange("imgui_position_range");
+static const IdString ImguiRect("imgui_rect");
+static const IdString ImguiDistanceField("imgui_distance_field");
+
+HlmsImguiDatablock::HlmsImguiDatablock(IdString name, HlmsImgui* creator, const HlmsMacroblock* macroblock,
+                                       const HlmsBlendblock* blendblock, const HlmsParamVec& params)
+    : HlmsDatablock(name, creator, macroblock, blendblock, params), mTexture(NULL), mSamplerblock(NULL),
+      mTextureArray(true), mDistanceField(false)
+{
+    HlmsSamplerblock sb;
+    sb.setFiltering(Ogre::TFO_TRILINEAR);
+    mSamplerblock = mCreator->getHlmsManager()->getSamplerblock(sb);
+}
+HlmsImguiDatablock::~HlmsImguiDatablock()
+{
+    if (mSamplerblock)
+        mCreator->getHlmsManager()->destroySamplerblock(mSamplerblock);
+}
+
+void HlmsImguiDatablock::setTexture(TextureGpu* tex, bool distanceField)
+{
+    mTexture = tex;
+    mTextureHash = tex ? static_cast<uint32>(tex->getName().mHash) : 0;
+
+    bool isArray = tex && tex->getTextureType() == TextureTypes::Type2DArray;
+    if (tex && (isArray != mTextureArray || distanceField != mDistanceField))
+    {
+        // the sampler type and the alpha decoding are baked into the shader
+        mTextureArray = isArray;
+        mDistanceField = distanceField;
+        flushRenderables();
+    }
+}
+//-----------------------------------------------------------------------------------
+HlmsImgui::HlmsImgui(Archive* dataFolder, ArchiveVec* libraryFolders, HlmsTypes type)
+    : Hlms(type, "imgui", dataFolder, libraryFolders)
+{
+}
+
+void HlmsImgui::getDefaultPaths(String& outDataFolderPath)
+{
+    RenderSystem* renderSystem = Root::getSingleton().getRenderSystem();
+
+    String shaderSyntax = "GLSL";
+    if (renderSystem->getName() == "Direct3D11 Rendering Subsystem")
+        shaderSyntax = "HLSL";
+
+    outDataFolderPath = "Hlms/Imgui/" + shaderSyntax;
+}
+
+HlmsDatablock* HlmsImgui::createDatablockImpl(IdString datablockName, const HlmsMacroblock* macroblockRef,
+                                              const HlmsBlendblock* blendblockRef, const HlmsParamVec& paramVec)
+{
+    return OGRE_NEW HlmsImguiDatablock(datablockName, this, macroblockRef, blendblockRef, paramVec);
+}
+
+void HlmsImgui::calculateHashForPreCreate(Renderable* renderable, PiecesMap* inOutPieces)
+{
+    const HlmsImguiDatablock* datablock = static_cast<const HlmsImguiDatablock*>(renderable->getDatablock());
+    setProperty(ImguiTexArray, datablock->mTextureArray);
+    setProperty(ImguiDistanceField, datablock->mDistanceField);
+
+    // packed vertices store scaled down normalized positions
+    const VertexArrayObjectArray& vaos = renderable->getVaos(VpNormal);
+    if (!vaos.empty())
+    {
+        const VertexElement2Vec& elements = vaos.front()->getVertexDeclaration().front();
+        if (elements.front().mType == VET_SHORT2_SNORM)
+            setProperty(ImguiPositionRange, IMGUI_PACKED_POSITION_RANGE);
+
+        // rect quads carry a second (border) colour
+        for (size_t i = 0; i < elements.size(); i++)
+        {
+            if (elements[i].mSemantic == VES_SPECULAR)
+                setProperty(ImguiRect, 1);
+        }
+    }
+}
+
+const HlmsCache* HlmsImgui::createShaderCacheEntry(uint32 renderableHash, const HlmsCache& passCache,
+                                                   uint32 finalHash, const QueuedRenderable& queuedRenderable)
+{
+    const HlmsCache* retVal = Hlms::createShaderCacheEntry(renderableHash, passCache, finalHash, queuedRenderable);
+
+    if (mShaderProfile == "hlsl" || mShaderProfile == "metal")
+        return retVal; // the texture slot is declared in the shader
+
+    GpuProgramParametersSharedPtr psParams = retVal->pso.pixelShader->getDefaultParameters();
+    psParams->setIgnoreMissingParams(true); // rect shaders do not sample texMap
+    psParams->setNamedConstant("texMap", 0);
+
+    mRenderSystem->_setPipelineStateObject(&retVal->pso);
+    mRenderSystem->bindGpuProgramParameters(GPT_FRAGMENT_PROGRAM, psParams, GPV_ALL);
+
+    return retVal;
+}
+//-----------------------------------------------------------------------------------
+uint32 HlmsImgui::fillBuffersFor(const HlmsCache* cache, const QueuedRenderable& queuedRenderable,
+                                 bool casterPass, uint32 lastCacheHash, uint32 lastTextureHash)
+{
+    OGRE_EXCEPT(Exception::ERR_NOT_IMPLEMENTED,
+                "Trying to use slow-path on a desktop implementation. "
+                "Change the RenderQueue settings.",
+                "HlmsImgui::fillBuffersFor");
+}
+uint32 HlmsImgui::fillBuffersForV1(const HlmsCache* cache, const QueuedRenderable& queuedRenderable,
+                                   bool casterPass, uint32 lastCacheHash, CommandBuffer* commandBuffer)
+{
+    return fillBuffersForImpl(queuedRenderable, lastCacheHash, commandBuffer);
+}
+uint32 HlmsImgui::fillBuffersForV2(const HlmsCache* cache, const QueuedRenderable& queuedRenderable,
+                                   bool casterPass, uint32 lastCacheHash, CommandBuffer* commandBuffer)
+{
+    return fillBuffersForImpl(queuedRenderable, lastCacheHash, commandBuffer);
+}
+
+uint32 HlmsImgui::fillBuffersForImpl(const QueuedRenderable& queuedRenderable, uint32 lastCacheHash,
+                                     CommandBuffer* commandBuffer)
+{
+    if (OGRE_EXTRACT_HLMS_TYPE_FROM_CACHE_HASH(lastCacheHash) != mType)
+    {
+        // another Hlms may have left more texture units bound
+        *commandBuffer->addCommand<CbTextureDisableFrom>() = CbTextureDisableFrom(1);
+    }
+
+    // every imgui draw can use a different texture, so always bind it.
+    // this is the only per-draw work: no const buffers are written
+    const HlmsImguiDatablock* datablock =
+        static_cast<const HlmsImguiDatablock*>(queuedRenderable.renderable->getDatablock());
+    *commandBuffer->addCommand<CbTexture>() =
+        CbTexture(0, datablock->getTexture(), datablock->getSamplerblock());
+
+    return 0;
+}
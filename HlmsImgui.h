@@ -0,0 +1,73 @@
+#pragma once
+
+#include <OgrePrerequisites.h>
+#include <OgreHlms.h>
+#include <OgreHlmsDatablock.h>
+
+/// packed positions store NDC / IMGUI_PACKED_POSITION_RANGE, so geometry may reach
+/// this far outside the screen before falling back to float positions
+#define IMGUI_PACKED_POSITION_RANGE 2
+
+namespace Ogre
+{
+    /// default Hlms slot used by the imgui binding, see ImguiManager::setHlmsType()
+    static const HlmsTypes HLMS_IMGUI = HLMS_USER3;
+
+    class HlmsImgui;
+
+    /// datablock holding just a texture and a samplerblock
+    /// there are no material parameters, so no const buffer is needed
+    class HlmsImguiDatablock : public HlmsDatablock
+    {
+        friend class HlmsImgui;
+
+    public:
+        HlmsImguiDatablock(IdString name, HlmsImgui* creator, const HlmsMacroblock* macroblock,
+                           const HlmsBlendblock* blendblock, const HlmsParamVec& params);
+        ~HlmsImguiDatablock();
+
+        /// cheap to call per draw. only switching between 2D and 2D array
+        /// or distance field textures requires the linked renderables to be re-hashed
+        void setTexture(TextureGpu* tex, bool distanceField = false);
+        TextureGpu* getTexture() const { return mTexture; }
+
+        const HlmsSamplerblock* getSamplerblock() const { return mSamplerblock; }
+
+    protected:
+        TextureGpu*             mTexture;
+        const HlmsSamplerblock* mSamplerblock;
+        bool                    mTextureArray;
+        bool                    mDistanceField;
+    };
+
+    /// minimal Hlms for imgui: one pass-through vertex shader, one textured pixel shader
+    /// vertices are expected in normalized device coordinates, so there are no pass or
+    /// per-object constant buffers at all
+    class HlmsImgui : public Hlms
+    {
+    public:
+        HlmsImgui(Archive* dataFolder, ArchiveVec* libraryFolders, HlmsTypes type = HLMS_IMGUI);
+
+        /// shader folder relative to the Hlms root, depending on the active RenderSystem
+        static void getDefaultPaths(String& outDataFolderPath);
+
+        virtual uint32 fillBuffersFor(const HlmsCache* cache, const QueuedRenderable& queuedRenderable,
+                                      bool casterPass, uint32 lastCacheHash, uint32 lastTextureHash);
+        virtual uint32 fillBuffersForV1(const HlmsCache* cache, const QueuedRenderable& queuedRenderable,
+                                        bool casterPass, uint32 lastCacheHash, CommandBuffer* commandBuffer);
+        virtual uint32 fillBuffersForV2(const HlmsCache* cache, const QueuedRenderable& queuedRenderable,
+                                        bool casterPass, uint32 lastCacheHash, CommandBuffer* commandBuffer);
+
+    protected:
+        virtual HlmsDatablock* createDatablockImpl(IdString datablockName, const HlmsMacroblock* macroblockRef,
+                                                   const HlmsBlendblock* blendblockRef, const HlmsParamVec& paramVec);
+
+        virtual const HlmsCache* createShaderCacheEntry(uint32 renderableHash, const HlmsCache& passCache,
+                                                        uint32 finalHash, const QueuedRenderable& queuedRenderable);
+
+        virtual void calculateHashForPreCreate(Renderable* renderable, PiecesMap* inOutPieces);
+
+        uint32 fillBuffersForImpl(const QueuedRenderable& queuedRenderable, uint32 lastCacheHash,
+                                  CommandBuffer* commandBuffer);
+    };
+}
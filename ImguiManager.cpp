@@ -1,4 +1,5 @@
 #include <imgui.h>
+#include <imgui_internal.h>
 #ifdef USE_FREETYPE
 #include <imgui_freetype.h>
 #endif
@@ -14,6 +15,7 @@
 #include <OgreString.h>
 #include <OgreStringConverter.h>
 #include <OgreViewport.h>
+#include <limits>
 #include <OgreHighLevelGpuProgramManager.h>
 #include <OgreHighLevelGpuProgram.h>
 #include <OgreUnifiedHighLevelGpuProgram.h>
@@ -24,8 +26,8 @@
 #include "OgreHardwareBufferManager.h"
 #include "OgreHlmsDatablock.h"
 #include "OgreHlmsManager.h"
-#include "OgreHlmsUnlit.h"
-#include "OgreHlmsUnlitDatablock.h"
+#include "OgreArchiveManager.h"
+#include "OgreResourceGroupManager.h"
 #include "OgreStagingTexture.h"
 #include "OgreTextureBox.h"
 #include "OgreLogManager.h"
@@ -42,6 +44,13 @@
 #include <Overlay/OgreFontManager.h>
 #endif
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define OGRE_IMGUI_USE_SSE2 1
+#include <emmintrin.h>
+#else
+#define OGRE_IMGUI_USE_SSE2 0
+#endif
+
 using namespace Ogre;
 
 // map sdl2 mouse buttons to imgui
@@ -57,6 +66,202 @@ static int sdl2imgui(int b)
     }
 }
 
+/// 12 byte vertex, see ImGUIRenderable::mPackedVertexElements
+struct ImDrawVertPacked
+{
+    int16 pos[2]; // NDC / IMGUI_PACKED_POSITION_RANGE
+    uint16 uv[2];
+    ImU32 col;
+};
+
+/// convert pixel space ImDrawVerts to the packed layout
+/// returns false if any position does not fit into the packed range, in which case
+/// the caller has to fall back to the float layout
+static bool packVertices(const ImDrawVert* src, ImDrawVertPacked* dst, int count, float width, float height)
+{
+    // pixel -> NDC -> SHORT_SNORM in a single multiply-add
+    const float maxShort = 32767.0f / IMGUI_PACKED_POSITION_RANGE;
+    const float sx = 2.0f * maxShort / width;
+    const float sy = -2.0f * maxShort / height;
+    const float ox = -maxShort;
+    const float oy = maxShort;
+
+    int i = 0;
+    float minPos[4] = {0, 0, 0, 0};
+    float maxPos[4] = {0, 0, 0, 0};
+#if OGRE_IMGUI_USE_SSE2
+    // pos.xy and uv.xy are adjacent, so one vertex fits one register. two vertices are
+    // converted per iteration and saturated down to 16 bit with a single pack.
+    // uvs are biased by -32768 so the signed pack covers the unsigned range
+    const __m128 scale = _mm_setr_ps(sx, sy, 65535.0f, 65535.0f);
+    const __m128 offset = _mm_setr_ps(ox, oy, -32768.0f, -32768.0f);
+    const __m128i uvBias = _mm_setr_epi16(0, 0, (short)0x8000, (short)0x8000, 0, 0, (short)0x8000, (short)0x8000);
+    __m128 mn = _mm_setzero_ps();
+    __m128 mx = _mm_setzero_ps();
+    for (; i + 2 <= count; i += 2)
+    {
+        __m128 a = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&src[i].pos.x), scale), offset);
+        __m128 b = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&src[i + 1].pos.x), scale), offset);
+        mn = _mm_min_ps(mn, _mm_min_ps(a, b));
+        mx = _mm_max_ps(mx, _mm_max_ps(a, b));
+
+        __m128i ab = _mm_xor_si128(_mm_packs_epi32(_mm_cvtps_epi32(a), _mm_cvtps_epi32(b)), uvBias);
+        _mm_storel_epi64((__m128i*)&dst[i], ab);
+        _mm_storel_epi64((__m128i*)&dst[i + 1], _mm_srli_si128(ab, 8));
+        dst[i].col = src[i].col;
+        dst[i + 1].col = src[i + 1].col;
+    }
+    _mm_storeu_ps(minPos, mn);
+    _mm_storeu_ps(maxPos, mx);
+#endif
+    for (; i < count; i++)
+    {
+        float x = src[i].pos.x * sx + ox;
+        float y = src[i].pos.y * sy + oy;
+        minPos[0] = std::min(minPos[0], x);
+        minPos[1] = std::min(minPos[1], y);
+        maxPos[0] = std::max(maxPos[0], x);
+        maxPos[1] = std::max(maxPos[1], y);
+        if (minPos[0] < -32767.0f || minPos[1] < -32767.0f || maxPos[0] > 32767.0f || maxPos[1] > 32767.0f)
+            return false;
+
+        dst[i].pos[0] = (int16)floorf(x + 0.5f);
+        dst[i].pos[1] = (int16)floorf(y + 0.5f);
+        dst[i].uv[0] = (uint16)floorf(Math::saturate(src[i].uv.x) * 65535.0f + 0.5f);
+        dst[i].uv[1] = (uint16)floorf(Math::saturate(src[i].uv.y) * 65535.0f + 0.5f);
+        dst[i].col = src[i].col;
+    }
+
+    return minPos[0] >= -32767.0f && minPos[1] >= -32767.0f && maxPos[0] <= 32767.0f && maxPos[1] <= 32767.0f;
+}
+
+/// copy the triangles of IdxBuffer[first, first + count) that touch clip to idxBuf
+/// tested against the pixel space positions, returns the number of indices kept
+static uint32 clipTriangles(const ImDrawList* drawList, uint32 first, uint32 count, const ImVec4& clip,
+                            ImVector<ImDrawIdx>& idxBuf)
+{
+    const ImDrawVert* vtx = drawList->VtxBuffer.Data;
+    const ImDrawIdx* idx = drawList->IdxBuffer.Data + first;
+
+    idxBuf.resize(count);
+    uint32 kept = 0;
+    for (uint32 t = 0; t + 3 <= count; t += 3)
+    {
+        const ImVec2& a = vtx[idx[t]].pos;
+        const ImVec2& b = vtx[idx[t + 1]].pos;
+        const ImVec2& c = vtx[idx[t + 2]].pos;
+        if (std::max(a.x, std::max(b.x, c.x)) <= clip.x || std::min(a.x, std::min(b.x, c.x)) >= clip.z ||
+            std::max(a.y, std::max(b.y, c.y)) <= clip.y || std::min(a.y, std::min(b.y, c.y)) >= clip.w)
+            continue;
+
+        idxBuf[kept++] = idx[t];
+        idxBuf[kept++] = idx[t + 1];
+        idxBuf[kept++] = idx[t + 2];
+    }
+    idxBuf.resize(kept);
+    return kept;
+}
+
+/// area of window that is guaranteed to be covered by its opaque background
+static bool getOccluderRect(const ImGuiWindow* window, ImVec4& rect)
+{
+    if (!window->Active || window->Hidden || window->Collapsed ||
+        (window->Flags & (ImGuiWindowFlags_ChildWindow | ImGuiWindowFlags_NoBackground)))
+        return false;
+
+    // the background is the first shape drawn into the window, so its first vertex carries the
+    // final colour including style.Alpha and SetNextWindowBgAlpha()
+    const ImDrawList* drawList = window->DrawList;
+    if (drawList->VtxBuffer.Size == 0 || (drawList->VtxBuffer[0].col & IM_COL32_A_MASK) != IM_COL32_A_MASK)
+        return false;
+
+    // the title bar may be translucent and rounded corners leave gaps
+    float inset = window->WindowRounding;
+    rect = ImVec4(window->Pos.x + inset, window->Pos.y + window->TitleBarHeight() + inset,
+                  window->Pos.x + window->Size.x - inset, window->Pos.y + window->Size.y - inset);
+    return rect.x < rect.z && rect.y < rect.w;
+}
+
+/// the FileSystem archive at path if it holds any files, NULL otherwise
+static Archive* loadTemplateArchive(const String& path)
+{
+    ArchiveManager& archiveMgr = ArchiveManager::getSingleton();
+    Archive* archive = archiveMgr.load(path, "FileSystem", true);
+    if (!archive->list(false, false)->empty())
+        return archive;
+    archiveMgr.unload(archive);
+    return NULL;
+}
+
+/// mark draw lists whose commands all lie behind an opaque window drawn later
+/// returns the number of occluded lists
+static uint32 findOccludedLists(const ImDrawData* drawData, std::vector<bool>& occluded)
+{
+    int numLists = drawData->CmdListsCount;
+    occluded.assign(numLists, false);
+
+    std::vector<ImVec4> occluders(numLists, ImVec4(0, 0, 0, 0));
+    std::vector<bool> isOccluder(numLists, false);
+    ImGuiContext& g = *GImGui;
+    for (int w = 0; w < g.Windows.Size; w++)
+    {
+        ImVec4 rect;
+        if (!getOccluderRect(g.Windows[w], rect))
+            continue;
+        for (int i = 0; i < numLists; i++)
+        {
+            if (drawData->CmdLists[i] == g.Windows[w]->DrawList)
+            {
+                occluders[i] = rect;
+                isOccluder[i] = true;
+            }
+        }
+    }
+
+    uint32 numOccluded = 0;
+    for (int i = 0; i < numLists; i++)
+    {
+        // everything a list draws is confined to the union of its clip rects
+        const ImDrawList* drawList = drawData->CmdLists[i];
+        ImVec4 bounds(FLT_MAX, FLT_MAX, -FLT_MAX, -FLT_MAX);
+        for (int j = 0; j < drawList->CmdBuffer.Size; j++)
+        {
+            const ImDrawCmd& cmd = drawList->CmdBuffer[j];
+            if (cmd.ElemCount == 0 && cmd.UserCallback == NULL)
+                continue;
+            bounds.x = std::min(bounds.x, cmd.ClipRect.x);
+            bounds.y = std::min(bounds.y, cmd.ClipRect.y);
+            bounds.z = std::max(bounds.z, cmd.ClipRect.z);
+            bounds.w = std::max(bounds.w, cmd.ClipRect.w);
+        }
+        if (bounds.x > bounds.z)
+            continue;
+
+        for (int j = i + 1; j < numLists; j++)
+        {
+            if (isOccluder[j] && bounds.x >= occluders[j].x && bounds.y >= occluders[j].y &&
+                bounds.z <= occluders[j].z && bounds.w <= occluders[j].w)
+            {
+                occluded[i] = true;
+                numOccluded++;
+                break;
+            }
+        }
+    }
+    return numOccluded;
+}
+
+/// vertex of an SDF shaded rect quad, see ImGUIRenderable::mRectVertexElements
+struct ImDrawVertRect
+{
+    ImVec2 pos;      // NDC
+    ImVec2 local;    // pixel offset from the rect center
+    ImVec2 halfSize; // pixels
+    ImVec2 params;   // rounding, border size
+    ImU32 fillCol;
+    ImU32 borderCol;
+};
+
 struct ImguiInputListener : public InputListener
 {
     ImguiInputListener()
@@ -180,6 +385,16 @@ ImguiManager::ImguiManager()
 {
     ImGui::CreateContext();
 	mSceneMgr = NULL;
+	mHlms = NULL;
+	mHlmsType = HLMS_IMGUI;
+	mOwnsHlms = false;
+	mHlmsFolder = "./";
+	mPackedVertices = false;
+	mDistanceFieldSpread = 0;
+	mRemote = NULL;
+	mOcclusionCulling = false;
+	mCullStats = CullStats();
+	mDroppedDrawsLogged = false;
 	mScreenWidth = 0;
 	mScreenHeight = 0;
 	mDisplayFunction = NULL;
@@ -187,11 +402,11 @@ ImguiManager::ImguiManager()
 }
 ImguiManager::~ImguiManager()
 {
+	delete mRemote;
     ImGui::DestroyContext();
 	Ogre::Root::getSingletonPtr()->removeFrameListener(this);
 
 	Ogre::HlmsManager *hlmsManager = Ogre::Root::getSingletonPtr()->getHlmsManager();
-	Ogre::HlmsUnlit *hlmsUnlit = static_cast<Ogre::HlmsUnlit*>(hlmsManager->getHlms(Ogre::HLMS_UNLIT));
 	Ogre::TextureGpuManager *textureMgr = Ogre::Root::getSingletonPtr()->getRenderSystem()->getTextureGpuManager();
 	
 	if(mFontTex != NULL)
@@ -202,13 +417,96 @@ ImguiManager::~ImguiManager()
 		if (mRenderables[i] != NULL)
 		{
 			mRenderables[i]->_setNullDatablock();
-			if (mRenderables[i]->mUnlitDatablock != NULL)
+			if (mRenderables[i]->mImguiDatablock != NULL)
 			{
-				hlmsUnlit->destroyDatablock(mRenderables[i]->mUnlitDatablock->getName());
-				mRenderables[i]->mUnlitDatablock = NULL;
+				mHlms->destroyDatablock(mRenderables[i]->mImguiDatablock->getName());
+				mRenderables[i]->mImguiDatablock = NULL;
 			}
 		}
 	}
+	if (mOwnsHlms)
+	{
+		hlmsManager->unregisterHlms(mHlmsType);
+		OGRE_DELETE mHlms;
+	}
+	mHlms = NULL;
+}
+
+void ImguiManager::rectCallback(const ImDrawList* parent_list, const ImDrawCmd* cmd)
+{
+	// only a marker: render() expands these commands itself
+}
+
+void ImguiManager::addRect(ImDrawList* drawList, const ImVec2& min, const ImVec2& max, ImU32 fillCol,
+	float rounding, float borderSize, ImU32 borderCol)
+{
+	// a rect quad costs 4 * 40 bytes, twice what imgui needs for an unrounded, borderless fill
+	if (rounding <= 0.0f && borderSize <= 0.0f)
+	{
+		drawList->AddRectFilled(min, max, fillCol);
+		return;
+	}
+
+	RectInstance inst = { min, max, rounding, borderSize, fillCol, borderCol };
+
+	// extend the previous batch if nothing was drawn in between and the clipping is unchanged
+	ImVec2 clipMin = drawList->GetClipRectMin();
+	ImVec2 clipMax = drawList->GetClipRectMax();
+	int numCmds = drawList->CmdBuffer.Size;
+	if (!mRectBatches.empty() && numCmds >= 2 && drawList->CmdBuffer[numCmds - 1].ElemCount == 0)
+	{
+		const ImDrawCmd& cmd = drawList->CmdBuffer[numCmds - 2];
+		RectBatch& batch = mRectBatches.back();
+		if (cmd.UserCallback == rectCallback &&
+			(size_t)(intptr_t)cmd.UserCallbackData == mRectBatches.size() - 1 &&
+			batch.first + batch.count == mRectInstances.size() &&
+			batch.count < MAX_RECTS_PER_BATCH &&
+			cmd.ClipRect.x == clipMin.x && cmd.ClipRect.y == clipMin.y &&
+			cmd.ClipRect.z == clipMax.x && cmd.ClipRect.w == clipMax.y)
+		{
+			mRectInstances.push_back(inst);
+			batch.count++;
+			return;
+		}
+	}
+
+	RectBatch batch = { mRectInstances.size(), 1 };
+	mRectInstances.push_back(inst);
+	mRectBatches.push_back(batch);
+	drawList->AddCallback(rectCallback, (void*)(intptr_t)(mRectBatches.size() - 1));
+}
+
+void ImguiManager::buildRectVertices(const RectBatch& batch, ImVector<ImDrawVertRect>& vtxBuf, ImVector<ImDrawIdx>& idxBuf)
+{
+	static const float corners[4][2] = { { -1, -1 }, { 1, -1 }, { 1, 1 }, { -1, 1 } };
+
+	vtxBuf.resize(batch.count * 4);
+	idxBuf.resize(batch.count * 6);
+	for (size_t r = 0; r < batch.count; r++)
+	{
+		const RectInstance& inst = mRectInstances[batch.first + r];
+		ImVec2 center((inst.min.x + inst.max.x) * 0.5f, (inst.min.y + inst.max.y) * 0.5f);
+		ImVec2 halfSize((inst.max.x - inst.min.x) * 0.5f, (inst.max.y - inst.min.y) * 0.5f);
+		float rounding = std::min(inst.rounding, std::min(halfSize.x, halfSize.y));
+
+		for (int c = 0; c < 4; c++)
+		{
+			// grow the quad by one pixel for the anti-aliased edge
+			ImDrawVertRect& v = vtxBuf[r * 4 + c];
+			v.local = ImVec2(corners[c][0] * (halfSize.x + 1.0f), corners[c][1] * (halfSize.y + 1.0f));
+			v.pos.x = ((center.x + v.local.x) / (Real)mScreenWidth)*2.0f - 1.0f;
+			v.pos.y = -(((center.y + v.local.y) / (Real)mScreenHeight)*2.0f - 1.0f);
+			v.halfSize = halfSize;
+			v.params = ImVec2(rounding, inst.borderSize);
+			v.fillCol = inst.fillCol;
+			v.borderCol = inst.borderCol;
+		}
+
+		ImDrawIdx base = (ImDrawIdx)(r * 4);
+		ImDrawIdx* idx = &idxBuf[r * 6];
+		idx[0] = base; idx[1] = base + 1; idx[2] = base + 2;
+		idx[3] = base; idx[4] = base + 2; idx[5] = base + 3;
+	}
 }
 
 void ImguiManager::init(Ogre::Window* win, Ogre::SceneManager* mgr, void(*fn)(bool* ))
@@ -222,7 +520,6 @@ void ImguiManager::init(Ogre::Window* win, Ogre::SceneManager* mgr, void(*fn)(bo
 	mSceneMgr->addRenderQueueListener(this);
 
 	createFontTexture();
-	createMaterial();
 	
 	SceneNode* dummyNode = OGRE_NEW SceneNode(0, 0, new NodeMemoryManager(), 0);
 	dummyNode->_getFullTransformUpdated();
@@ -235,6 +532,16 @@ void ImguiManager::init(Ogre::Window* win, Ogre::SceneManager* mgr, void(*fn)(bo
 		mRenderables[i]->setVisibilityFlags((1u<<i));
 		dummyNode->attachObject(mRenderables[i]);
 	}
+
+	createMaterial();
+}
+
+void ImguiManager::setRemotePort(uint16 port, const String& bindAddress)
+{
+	delete mRemote;
+	mRemote = NULL;
+	if (port != 0)
+		mRemote = new ImguiRemoteServer(port, bindAddress);
 }
 
 InputListener* ImguiManager::getInputListener()
@@ -284,7 +591,11 @@ void ImguiManager::render()
 	
 	ImGui::Render();
 	ImDrawData* draw_data = ImGui::GetDrawData();
+	if (mRemote)
+		mRemote->sendFrame(draw_data, (ImTextureID)mFontTex);
 	ImVector<ImDrawVert> vtxBuf = ImVector<ImDrawVert>();
+	ImVector<ImDrawVertPacked> packedBuf = ImVector<ImDrawVertPacked>();
+	ImVector<ImDrawVertRect> rectBuf = ImVector<ImDrawVertRect>();
 	ImVector<ImDrawIdx> idxBuf = ImVector<ImDrawIdx>();
 
 	Ogre::CompositorManager2 *compositorManager = Root::getSingletonPtr()->getCompositorManager2();
@@ -292,6 +603,15 @@ void ImguiManager::render()
 	CompositorTargetDef* target = nodedef->getTargetPass(0);
 	Ogre::CompositorPassDefVec vec = target->getCompositorPassesNonConst();
 
+	mCullStats = CullStats();
+	std::vector<bool> occluded(draw_data->CmdListsCount, false);
+	if (mOcclusionCulling)
+		mCullStats.culledLists = findOccludedLists(draw_data, occluded);
+
+	// commands are clipped against the screen as well as their clip rect
+	const ImVec4 screenRect(0, 0, (float)mScreenWidth, (float)mScreenHeight);
+
+	// only submitted commands take a renderable and its compositor pass, culled ones leave no gap
 	uint32 rend_offset = 0;
 	for (int i = 0; i < draw_data->CmdListsCount; ++i)
 	{
@@ -299,29 +619,50 @@ void ImguiManager::render()
 		uint32 startIdx = 0;
 		uint32 startVtx = 0;
 
-		vtxBuf.resize(draw_list->VtxBuffer.Size);
-		std::copy(draw_list->VtxBuffer.Data, draw_list->VtxBuffer.Data + (draw_list->VtxBuffer.Size), vtxBuf.begin());
-		for (int l = 0; l < draw_list->VtxBuffer.Size; l++)
-		{
-			vtxBuf[l].pos.x = (vtxBuf[l].pos.x / (Real)mScreenWidth)*2.0f - 1.0f;
-			vtxBuf[l].pos.y = -((vtxBuf[l].pos.y / (Real)mScreenHeight)*2.0f - 1.0f);
-		}
-
 		VaoManager *vaoManager = mSceneMgr->getDestinationRenderSystem()->getVaoManager();
 
 		if (vertexBuffer[i])
 			vaoManager->destroyVertexBuffer(vertexBuffer[i]);
-		try
+		vertexBuffer[i] = 0;
+
+		// occluded lists upload nothing, all of their commands are culled below
+		bool packed = false;
+		if (mPackedVertices && !occluded[i])
 		{
-			vertexBuffer[i] = vaoManager->createVertexBuffer(mRenderables[0]->mVertexElements, vtxBuf.size(),
-				BT_IMMUTABLE,
-				vtxBuf.Data, false);
+			packedBuf.resize(draw_list->VtxBuffer.Size);
+			packed = packVertices(draw_list->VtxBuffer.Data, packedBuf.Data, draw_list->VtxBuffer.Size,
+				(float)mScreenWidth, (float)mScreenHeight);
 		}
-		catch (Ogre::Exception &e)
+		if (!packed && !occluded[i])
 		{
-			OGRE_FREE_SIMD(vertexBuffer, Ogre::MEMCATEGORY_GEOMETRY);
-			vertexBuffer[i] = 0;
-			throw e;
+			vtxBuf.resize(draw_list->VtxBuffer.Size);
+			std::copy(draw_list->VtxBuffer.Data, draw_list->VtxBuffer.Data + (draw_list->VtxBuffer.Size), vtxBuf.begin());
+			for (int l = 0; l < draw_list->VtxBuffer.Size; l++)
+			{
+				vtxBuf[l].pos.x = (vtxBuf[l].pos.x / (Real)mScreenWidth)*2.0f - 1.0f;
+				vtxBuf[l].pos.y = -((vtxBuf[l].pos.y / (Real)mScreenHeight)*2.0f - 1.0f);
+			}
+		}
+
+		if (!occluded[i])
+		{
+			try
+			{
+				if (packed)
+					vertexBuffer[i] = vaoManager->createVertexBuffer(mRenderables[0]->mPackedVertexElements, packedBuf.size(),
+						BT_IMMUTABLE,
+						packedBuf.Data, false);
+				else
+					vertexBuffer[i] = vaoManager->createVertexBuffer(mRenderables[0]->mVertexElements, vtxBuf.size(),
+						BT_IMMUTABLE,
+						vtxBuf.Data, false);
+			}
+			catch (Ogre::Exception &e)
+			{
+				OGRE_FREE_SIMD(vertexBuffer, Ogre::MEMCATEGORY_GEOMETRY);
+				vertexBuffer[i] = 0;
+				throw e;
+			}
 		}
 
 		for (int j = 0; j < draw_list->CmdBuffer.Size; ++j)
@@ -334,53 +675,154 @@ void ImguiManager::render()
 			else
 				tex = mFontTex;
 
-			idxBuf.resize(drawCmd->ElemCount);
-			std::copy(draw_list->IdxBuffer.Data + startIdx, draw_list->IdxBuffer.Data + startIdx + drawCmd->ElemCount, idxBuf.begin());
-			startIdx += drawCmd->ElemCount;
-
-			uint32 rend_idx = (rend_offset + j) % MAX_NUM_RENDERABLES;
+			// only valid while visible, see below
+			uint32 rend_idx = rend_offset;
 			uint32 pass_idx = 2 + rend_idx;
 
+			ImGUIRenderable::VertexLayout layout = packed ? ImGUIRenderable::VL_PACKED : ImGUIRenderable::VL_DEFAULT;
+			VertexBufferPacked *cmdVertexBuffer = vertexBuffer[i];
+			ImVec4 clip(std::max(drawCmd->ClipRect.x, screenRect.x), std::max(drawCmd->ClipRect.y, screenRect.y),
+				std::min(drawCmd->ClipRect.z, screenRect.z), std::min(drawCmd->ClipRect.w, screenRect.w));
+			bool visible = !occluded[i] && clip.x < clip.z && clip.y < clip.w;
+			// once every renderable is taken, further draws are dropped rather than overwriting earlier ones
+			bool dropped = visible && rend_offset >= MAX_NUM_RENDERABLES;
+			visible = visible && !dropped;
+
+			bool submit = true;
+			if (drawCmd->UserCallback == rectCallback)
+			{
+				const RectBatch& batch = mRectBatches[(size_t)(intptr_t)drawCmd->UserCallbackData];
+				if (visible)
+				{
+					// expand the queued rects into one quad each
+					buildRectVertices(batch, rectBuf, idxBuf);
+					if (mRectVertexBuffers[rend_idx])
+						vaoManager->destroyVertexBuffer(mRectVertexBuffers[rend_idx]);
+					mRectVertexBuffers[rend_idx] = vaoManager->createVertexBuffer(mRenderables[0]->mRectVertexElements, rectBuf.size(),
+						BT_IMMUTABLE,
+						rectBuf.Data, false);
+					cmdVertexBuffer = mRectVertexBuffers[rend_idx];
+					layout = ImGUIRenderable::VL_RECT;
+				}
+				else
+				{
+					(dropped ? mCullStats.droppedDraws : mCullStats.culledDraws)++;
+					mCullStats.culledIndices += batch.count * 6;
+					submit = false;
+				}
+			}
+			else if (drawCmd->UserCallback != NULL || drawCmd->ElemCount == 0)
+			{
+#ifdef ImDrawCallback_ResetRenderState
+				// a sentinel, not a function. there is no render state to reset
+				if (drawCmd->UserCallback != NULL && drawCmd->UserCallback != ImDrawCallback_ResetRenderState)
+#else
+				if (drawCmd->UserCallback != NULL)
+#endif
+					drawCmd->UserCallback(draw_list, drawCmd);
+				submit = false;
+			}
+			else
+			{
+				// only upload the triangles that survive the scissor test
+				uint32 numIndices = visible ? clipTriangles(draw_list, startIdx, drawCmd->ElemCount, clip, idxBuf) : 0;
+				startIdx += drawCmd->ElemCount;
+				mCullStats.culledIndices += drawCmd->ElemCount - numIndices;
+				if (numIndices == 0)
+				{
+					(dropped ? mCullStats.droppedDraws : mCullStats.culledDraws)++;
+					submit = false;
+				}
+			}
+
+			if (!submit)
+				continue;
+
 			vec[pass_idx]->mVpRect[0].mVpLeft = 0;
 			vec[pass_idx]->mVpRect[0].mVpTop = 0;
 			vec[pass_idx]->mVpRect[0].mVpWidth = 1;
 			vec[pass_idx]->mVpRect[0].mVpHeight = 1;
-			vec[pass_idx]->mVpRect[0].mVpScissorLeft = ((Real)drawCmd->ClipRect.x / (Real)mScreenWidth);
-			vec[pass_idx]->mVpRect[0].mVpScissorTop = ((Real)(drawCmd->ClipRect.y) / (Real)mScreenHeight);
-			vec[pass_idx]->mVpRect[0].mVpScissorWidth = ((Real)(drawCmd->ClipRect.z - drawCmd->ClipRect.x) / (Real)mScreenWidth);
-			vec[pass_idx]->mVpRect[0].mVpScissorHeight = ((Real)(drawCmd->ClipRect.w - drawCmd->ClipRect.y) / (Real)mScreenHeight);
-			
-			mRenderables[rend_idx]->updateVertexData(vertexBuffer[i], idxBuf);
+			vec[pass_idx]->mVpRect[0].mVpScissorLeft = ((Real)clip.x / (Real)mScreenWidth);
+			vec[pass_idx]->mVpRect[0].mVpScissorTop = ((Real)(clip.y) / (Real)mScreenHeight);
+			vec[pass_idx]->mVpRect[0].mVpScissorWidth = ((Real)(clip.z - clip.x) / (Real)mScreenWidth);
+			vec[pass_idx]->mVpRect[0].mVpScissorHeight = ((Real)(clip.w - clip.y) / (Real)mScreenHeight);
 			
-			Ogre::HlmsManager *hlmsManager = Ogre::Root::getSingletonPtr()->getHlmsManager();
-			Ogre::HlmsUnlit *hlmsUnlit = static_cast<Ogre::HlmsUnlit*>(hlmsManager->getHlms(Ogre::HLMS_UNLIT));
-
-			Ogre::String name = "imgui_";
-			name.append(StringConverter::toString(rend_idx));
-			HlmsUnlitDatablock* datablock =(HlmsUnlitDatablock*) hlmsUnlit->getDatablock(name);
-			HlmsSamplerblock sb;
-			sb.setFiltering(Ogre::TFO_TRILINEAR);
-			datablock->setTexture(0, tex, &sb);
-			mRenderables[rend_idx]->setDatablock(datablock);
-			mRenderables[rend_idx]->mUnlitDatablock = datablock;
+			mRenderables[rend_idx]->updateVertexData(cmdVertexBuffer, idxBuf);
+			mRenderables[rend_idx]->mImguiDatablock->setTexture(tex, mDistanceFieldSpread > 0 && tex == mFontTex);
+			// the hash depends on the vertex layout, so it can only be computed once a vao exists.
+			// afterwards only the texture changes, which needs no re-hashing
+			if (!mRenderables[rend_idx]->mInitialized || mRenderables[rend_idx]->mVertexLayout != layout)
+			{
+				mRenderables[rend_idx]->mVertexLayout = layout;
+				mRenderables[rend_idx]->setDatablock(mRenderables[rend_idx]->mImguiDatablock);
+			}
 			mRenderables[rend_idx]->setVisible(true);
 			mRenderables[rend_idx]->mInitialized = true;
+			rend_offset++;
 		}
 		vtxBuf.clear();
-		rend_offset += draw_list->CmdBuffer.Size;
 	}
 	for (int l = rend_offset; l < MAX_NUM_RENDERABLES; l++)
 	{
 		if(mRenderables[l]->mInitialized)
 			mRenderables[l]->setVisible(false);
 	}
+	if (mCullStats.droppedDraws > 0 && !mDroppedDrawsLogged)
+	{
+		LogManager::getSingleton().logMessage("ImguiManager: more than " + StringConverter::toString(MAX_NUM_RENDERABLES) +
+			" draws in a frame, " + StringConverter::toString(mCullStats.droppedDraws) + " were dropped", LML_CRITICAL);
+		mDroppedDrawsLogged = true;
+	}
 }
 //-----------------------------------------------------------------------------------
 void ImguiManager::createMaterial()
 {
+	Ogre::HlmsManager *hlmsManager = Ogre::Root::getSingletonPtr()->getHlmsManager();
+	Hlms *existing = hlmsManager->getHlms(mHlmsType);
+	if (existing != NULL)
+	{
+		// only reuse an HlmsImgui, the slot may belong to another Hlms such as HlmsTerra
+		if (existing->getTypeNameStr() != "imgui")
+			OGRE_EXCEPT(Exception::ERR_DUPLICATE_ITEM,
+				"Hlms slot " + StringConverter::toString(mHlmsType) + " is used by '" + existing->getTypeNameStr() +
+				"', pick a free one with ImguiManager::setHlmsType()",
+				"ImguiManager::createMaterial");
+		mHlms = static_cast<HlmsImgui*>(existing);
+	}
+	else
+	{
+		String dataFolderPath;
+		HlmsImgui::getDefaultPaths(dataFolderPath);
+		// look in the folder given to setHlmsFolder() first, then in the FileSystem resource locations,
+		// so the templates may also ship with the application's other media
+		Archive *archive = loadTemplateArchive(mHlmsFolder + dataFolderPath);
+		ResourceGroupManager &resourceMgr = ResourceGroupManager::getSingleton();
+		StringVector groups = resourceMgr.getResourceGroups();
+		for (size_t g = 0; g < groups.size() && archive == NULL; g++)
+		{
+			const ResourceGroupManager::LocationList &locations = resourceMgr.getResourceLocationList(groups[g]);
+			for (ResourceGroupManager::LocationList::const_iterator it = locations.begin();
+				it != locations.end() && archive == NULL; ++it)
+			{
+				if ((*it)->archive->getType() == "FileSystem")
+					archive = loadTemplateArchive((*it)->archive->getName() + "/" + dataFolderPath);
+			}
+		}
+		if (archive == NULL)
+			OGRE_EXCEPT(Exception::ERR_FILE_NOT_FOUND,
+				"cannot find the Hlms templates " + dataFolderPath + " in '" + mHlmsFolder +
+				"' or any FileSystem resource location, see ImguiManager::setHlmsFolder()",
+				"ImguiManager::createMaterial");
+		ArchiveVec library;
+		mHlms = OGRE_NEW HlmsImgui(archive, &library, mHlmsType);
+		hlmsManager->registerHlms(mHlms);
+		mOwnsHlms = true;
+	}
+
 	HlmsMacroblock mb;
 	mb.mCullMode = CULL_NONE;
 	mb.mDepthFunc = Ogre::CMPF_ALWAYS_PASS;
+	mb.mDepthWrite = false;
 	mb.mScissorTestEnabled = true;
 	HlmsBlendblock bb;
 	bb.mIsTransparent = true;
@@ -392,20 +834,20 @@ void ImguiManager::createMaterial()
 	bb.mDestBlendFactorAlpha = Ogre::SBF_ZERO;
 	bb.mBlendOperation = Ogre::SBO_ADD;
 	bb.mBlendOperationAlpha = Ogre::SBO_ADD;
-	
+
+	// the HlmsManager shares identical blocks, so all datablocks use one macroblock and one blendblock.
+	// there is one datablock per renderable, as each draw in a frame may sample a different texture
 	for (int i = 0; i < MAX_NUM_RENDERABLES; i++)
 	{
-		Ogre::HlmsManager *hlmsManager = Ogre::Root::getSingletonPtr()->getHlmsManager();
-		Ogre::HlmsUnlit *hlmsUnlit = static_cast<Ogre::HlmsUnlit*>(hlmsManager->getHlms(Ogre::HLMS_UNLIT));
-
 		Ogre::String datablockName = "imgui_";
 		datablockName.append(StringConverter::toString(i));
-		Ogre::HlmsUnlitDatablock *datablock = static_cast<Ogre::HlmsUnlitDatablock*>(
-			hlmsUnlit->createDatablock(datablockName,
+		mRenderables[i]->mImguiDatablock = static_cast<HlmsImguiDatablock*>(
+			mHlms->createDatablock(datablockName,
 				datablockName,
 				mb,
 				bb,
-				Ogre::HlmsParamVec()));
+				Ogre::HlmsParamVec(),
+				false));
 	}
 }
 
@@ -447,19 +889,146 @@ ImFont* ImguiManager::addFont(const String& name, const String& group)
 #endif
 }
 
+/// 1D squared euclidean distance transform of the sampled function f
+/// see Felzenszwalb & Huttenlocher, "Distance Transforms of Sampled Functions"
+static void distanceTransform1D(const float* f, float* d, int* v, float* z, int n)
+{
+    int k = 0;
+    v[0] = 0;
+    z[0] = -std::numeric_limits<float>::max();
+    z[1] = std::numeric_limits<float>::max();
+    for(int q = 1; q < n; q++)
+    {
+        float s = ((f[q] + q * q) - (f[v[k]] + v[k] * v[k])) / (2 * q - 2 * v[k]);
+        while(s <= z[k])
+        {
+            k--;
+            s = ((f[q] + q * q) - (f[v[k]] + v[k] * v[k])) / (2 * q - 2 * v[k]);
+        }
+        k++;
+        v[k] = q;
+        z[k] = s;
+        z[k + 1] = std::numeric_limits<float>::max();
+    }
+
+    k = 0;
+    for(int q = 0; q < n; q++)
+    {
+        while(z[k + 1] < q)
+            k++;
+        d[q] = (q - v[k]) * (q - v[k]) + f[v[k]];
+    }
+}
+
+/// squared euclidean distance transform in place. dist holds the squared distance each pixel
+/// starts with, 0 at the seeds and very large elsewhere
+static void distanceTransform2D(std::vector<float>& dist, int width, int height)
+{
+    int n = std::max(width, height);
+    std::vector<float> f(n), d(n), z(n + 1);
+    std::vector<int> v(n);
+
+    for(int x = 0; x < width; x++)
+    {
+        for(int y = 0; y < height; y++)
+            f[y] = dist[y * width + x];
+        distanceTransform1D(f.data(), d.data(), v.data(), z.data(), height);
+        for(int y = 0; y < height; y++)
+            dist[y * width + x] = d[y];
+    }
+    for(int y = 0; y < height; y++)
+    {
+        distanceTransform1D(&dist[y * width], d.data(), v.data(), z.data(), width);
+        std::copy(d.begin(), d.begin() + width, dist.begin() + y * width);
+    }
+}
+
+/// convert the glyphs of a coverage atlas into a signed distance field in place.
+/// 128 marks the glyph edge, +-spread pixels map to 255 and 0.
+/// mask is set to 255 for distance texels. the custom rects (white pixel, mouse cursors, baked lines,
+/// custom glyphs) keep their coverage and a mask of 0
+static void buildDistanceField(const ImFontAtlas* atlas, unsigned char* alpha, int width, int height, int spread,
+                               std::vector<unsigned char>& mask)
+{
+    mask.assign(width * height, 0);
+    for(int f = 0; f < atlas->Fonts.Size; f++)
+    {
+        const ImFont* font = atlas->Fonts[f];
+        for(int g = 0; g < font->Glyphs.Size; g++)
+        {
+            // the distance is stored around the glyph as well, which its padding leaves room for
+            const ImFontGlyph& glyph = font->Glyphs[g];
+            if(glyph.U0 >= glyph.U1 || glyph.V0 >= glyph.V1)
+                continue;
+            int x0 = std::max(int(floorf(glyph.U0 * width)) - spread, 0);
+            int y0 = std::max(int(floorf(glyph.V0 * height)) - spread, 0);
+            int x1 = std::min(int(ceilf(glyph.U1 * width)) + spread, width);
+            int y1 = std::min(int(ceilf(glyph.V1 * height)) + spread, height);
+            for(int y = y0; y < y1; y++)
+                memset(&mask[y * width + x0], 255, x1 - x0);
+        }
+    }
+    for(int r = 0; r < atlas->CustomRects.Size; r++)
+    {
+        // custom rects are packed without padding, so glyph margins may reach into them
+        const auto& rect = atlas->CustomRects[r];
+        for(int y = rect.Y; y < std::min(int(rect.Y + rect.Height), height); y++)
+            memset(&mask[y * width + rect.X], 0, std::min(int(rect.Width), width - rect.X));
+    }
+
+    // seed from the coverage: a partially covered pixel is about alpha - 0.5 pixels inside the edge.
+    // custom rects must not count as glyph edges
+    const float farAway = 1e20f;
+    std::vector<float> toInside(width * height), toOutside(width * height);
+    for(int i = 0; i < width * height; i++)
+    {
+        float a = mask[i] ? alpha[i] / 255.0f : 0.0f;
+        toInside[i] = a >= 1.0f ? 0.0f : a <= 0.0f ? farAway : Math::Sqr(std::max(0.5f - a, 0.0f));
+        toOutside[i] = a <= 0.0f ? 0.0f : a >= 1.0f ? farAway : Math::Sqr(std::max(a - 0.5f, 0.0f));
+    }
+    distanceTransform2D(toInside, width, height);
+    distanceTransform2D(toOutside, width, height);
+
+    for(int i = 0; i < width * height; i++)
+    {
+        if(!mask[i])
+            continue;
+        float signedDist = std::sqrt(toOutside[i]) - std::sqrt(toInside[i]);
+        float value = 0.5f + signedDist / (2.0f * spread);
+        alpha[i] = (unsigned char)(Math::saturate(value) * 255.0f + 0.5f);
+    }
+}
+
 void ImguiManager::createFontTexture()
 {
     // Build texture atlas
     ImGuiIO& io = ImGui::GetIO();
     if(io.Fonts->Fonts.empty())
         io.Fonts->AddFontDefault();
+    if(mDistanceFieldSpread > 0)
+    {
+        // glyphs must not see their neighbours within the encoded distance
+        io.Fonts->TexGlyphPadding = std::max(io.Fonts->TexGlyphPadding, mDistanceFieldSpread);
+    }
 #ifdef USE_FREETYPE
     ImGuiFreeType::BuildFontAtlas(io.Fonts, 0);
 #endif
 
     unsigned char* pixels;
     int width, height;
+    std::vector<unsigned char> distanceMask;
+    if(mDistanceFieldSpread > 0)
+    {
+        // replace coverage by distance before imgui expands the atlas to RGBA
+        io.Fonts->GetTexDataAsAlpha8(&pixels, &width, &height);
+        buildDistanceField(io.Fonts, pixels, width, height, mDistanceFieldSpread, distanceMask);
+    }
     io.Fonts->GetTexDataAsRGBA32(&pixels, &width, &height);
+    for(size_t i = 0; i < distanceMask.size(); i++)
+    {
+        // red tells the shader which texels to decode, vertex colours supply the rgb anyway
+        pixels[i * 4] = distanceMask[i];
+    }
 
 	Ogre::TextureGpuManager *textureMgr = Ogre::Root::getSingletonPtr()->getRenderSystem()->getTextureGpuManager();
 	mFontTex = textureMgr->createOrRetrieveTexture("ImguiFontTex", GpuPageOutStrategy::Discard, Ogre::TextureFlags::ManualTexture,
@@ -502,6 +1071,12 @@ void ImguiManager::newFrame(float deltaTime,const Ogre::Rect & windowRect)
     // Setup display size (every frame to accommodate for window resizing)
      io.DisplaySize = ImVec2((float)(windowRect.right - windowRect.left), (float)(windowRect.bottom - windowRect.top));
 	 
+    if(mRemote)
+        mRemote->pollInput(getInputListener());
+
+    mRectInstances.clear();
+    mRectBatches.clear();
+
     // Start the frame
     ImGui::NewFrame();
 }
@@ -519,10 +1094,23 @@ ImguiManager::ImGUIRenderable::ImGUIRenderable(IdType id, ObjectMemoryManager *o
 void ImguiManager::ImGUIRenderable::initImGUIRenderable(void)
 {
 	mInitialized = false;
-	mUnlitDatablock = NULL;
+	mVertexLayout = VL_DEFAULT;
+	mImguiDatablock = NULL;
 	mVertexElements.push_back(Ogre::VertexElement2(Ogre::VertexElementType::VET_FLOAT2, Ogre::VertexElementSemantic::VES_POSITION));
 	mVertexElements.push_back(Ogre::VertexElement2(Ogre::VertexElementType::VET_FLOAT2, Ogre::VertexElementSemantic::VES_TEXTURE_COORDINATES));
 	mVertexElements.push_back(Ogre::VertexElement2(Ogre::VertexElementType::VET_COLOUR, Ogre::VertexElementSemantic::VES_DIFFUSE));
+
+	// layout of ImDrawVertPacked
+	mPackedVertexElements.push_back(Ogre::VertexElement2(Ogre::VertexElementType::VET_SHORT2_SNORM, Ogre::VertexElementSemantic::VES_POSITION));
+	mPackedVertexElements.push_back(Ogre::VertexElement2(Ogre::VertexElementType::VET_USHORT2_NORM, Ogre::VertexElementSemantic::VES_TEXTURE_COORDINATES));
+	mPackedVertexElements.push_back(Ogre::VertexElement2(Ogre::VertexElementType::VET_COLOUR, Ogre::VertexElementSemantic::VES_DIFFUSE));
+
+	// layout of ImDrawVertRect
+	mRectVertexElements.push_back(Ogre::VertexElement2(Ogre::VertexElementType::VET_FLOAT2, Ogre::VertexElementSemantic::VES_POSITION));
+	mRectVertexElements.push_back(Ogre::VertexElement2(Ogre::VertexElementType::VET_FLOAT4, Ogre::VertexElementSemantic::VES_TEXTURE_COORDINATES));
+	mRectVertexElements.push_back(Ogre::VertexElement2(Ogre::VertexElementType::VET_FLOAT2, Ogre::VertexElementSemantic::VES_TEXTURE_COORDINATES));
+	mRectVertexElements.push_back(Ogre::VertexElement2(Ogre::VertexElementType::VET_COLOUR, Ogre::VertexElementSemantic::VES_DIFFUSE));
+	mRectVertexElements.push_back(Ogre::VertexElement2(Ogre::VertexElementType::VET_COLOUR, Ogre::VertexElementSemantic::VES_SPECULAR));
 }
 //-----------------------------------------------------------------------------------
 ImguiManager::ImGUIRenderable::~ImGUIRenderable()
@@ -597,8 +1185,6 @@ void ImguiManager::ImGUIRenderable::updateVertexData(Ogre::VertexBufferPacked *v
 
 	mVaoPerLod[0].push_back(vao);
 	mVaoPerLod[1].push_back(vao);
-	Ogre::HlmsManager *hlmsManager = Ogre::Root::getSingletonPtr()->getHlmsManager();
-	Ogre::HlmsUnlit *hlmsUnlit = static_cast<Ogre::HlmsUnlit*>(hlmsManager->getHlms(Ogre::HLMS_UNLIT));
 }
 //-----------------------------------------------------------------------------------
 const LightList& ImguiManager::ImGUIRenderable::getLights(void) const
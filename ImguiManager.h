@@ -9,12 +9,18 @@
 #include <OgreResourceGroupManager.h>
 #include <OgreRenderable.h>
 #include <OgreRenderOperation.h>
-#include <OgreHlmsUnlitDatablock.h>
 #include <OgreMovableObject.h>
 #include <OgreRenderQueueListener.h>
 #include "SDL.h"
 
+#include "HlmsImgui.h"
+#include "ImguiRemote.h"
+
 #define MAX_NUM_RENDERABLES 30
+// keeps the quads of a batch addressable with 16 bit indices
+#define MAX_RECTS_PER_BATCH 16384
+
+struct ImDrawVertRect;
 
 class InputListener
 {
@@ -50,10 +56,62 @@ namespace Ogre
         /// must be called before init()
         ImFont* addFont(const String& name, const String& group = ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
 
+        /// folder containing Hlms/Imgui/{GLSL,HLSL}, "./" by default. if the templates are not there, the
+        /// FileSystem resource locations are searched for Hlms/Imgui. init() throws if neither has them
+        /// must be called before init()
+        void setHlmsFolder(const String& folder) { mHlmsFolder = folder; }
+
+        /// Hlms slot to register HlmsImgui in, HLMS_USER3 by default. change it if the application
+        /// already uses that slot, e.g. for HlmsTerra. an HlmsImgui registered there beforehand is reused
+        /// must be called before init()
+        void setHlmsType(HlmsTypes type) { mHlmsType = type; }
+
+        /// upload positions as VET_SHORT2_SNORM and uvs as VET_USHORT2_NORM, i.e. 12 instead of 20 bytes per vertex.
+        /// draw lists reaching too far off screen to be packed fall back to the float layout
+        void setPackedVertices(bool enable) { mPackedVertices = enable; }
+
+        /// store the font atlas as a signed distance field encoding +-spread pixels around each glyph edge.
+        /// text then stays sharp at any scale (io.FontGlobalScale, SetWindowFontScale) without rebuilding the atlas,
+        /// so add each face just once, at the largest size needed. 0 disables
+        /// must be called before init()
+        void setDistanceFieldFont(int spread = 4) { mDistanceFieldSpread = spread; }
+        int getDistanceFieldFont() const { return mDistanceFieldSpread; }
+
+        /// stream every rendered frame to a RemoteViewer connecting on port and apply the input it sends back.
+        /// there is no authentication, so by default only viewers on this machine can connect. pass the
+        /// address of an interface, or "0.0.0.0" for all of them, to accept remote viewers. 0 stops streaming
+        void setRemotePort(uint16 port, const String& bindAddress = "127.0.0.1");
+        ImguiRemoteServer* getRemoteServer() const { return mRemote; }
+
+        /// skip the draw lists of windows that are completely hidden behind an opaque window drawn later.
+        /// only the parts of a window covered by its background count, so title bars and rounded corners never occlude
+        void setOcclusionCulling(bool enable) { mOcclusionCulling = enable; }
+
+        /// draw work removed by render() before reaching the GPU
+        struct CullStats
+        {
+            uint32 culledDraws;   ///< draw commands that were not submitted
+            uint32 culledIndices; ///< indices that were not uploaded, including those of culled draws
+            uint32 culledLists;   ///< draw lists skipped by occlusion culling
+            uint32 droppedDraws;  ///< visible draw commands beyond the MAX_NUM_RENDERABLES per frame, not drawn
+        };
+        /// statistics of the last render()
+        const CullStats& getCullStats() const { return mCullStats; }
+
         virtual void init(Window* win, SceneManager* mgr, void(*fn)(bool*));
 
         virtual void newFrame(float deltaTime,const Ogre::Rect & windowRect);
 
+        /// draw a filled and/or bordered (rounded) rectangle to drawList without tessellating it on the CPU.
+        /// it becomes a single quad, shaded by a signed distance function on the GPU.
+        /// consecutive rects with the same clipping are batched into one draw.
+        /// a quad takes 160 bytes of vertices, so this pays off for rounded and bordered rects, which imgui
+        /// tessellates into many triangles. plain rects are passed on to drawList->AddRectFilled().
+        /// each batch is a draw of its own and splits the surrounding imgui draw in two, so a rect between
+        /// other widgets costs up to 3 of the MAX_NUM_RENDERABLES draws per frame instead of 1
+        void addRect(ImDrawList* drawList, const ImVec2& min, const ImVec2& max, ImU32 fillCol,
+                     float rounding = 0.0f, float borderSize = 0.0f, ImU32 borderCol = 0);
+
 		virtual void render();
 
         //inherited from FrameListener
@@ -91,26 +149,65 @@ namespace Ogre
 			virtual const String& getMovableType(void) const;
 
             MaterialPtr              mMaterial;
-			HlmsUnlitDatablock		 *mUnlitDatablock;
+			HlmsImguiDatablock		 *mImguiDatablock;
             Matrix4                  mXform;
+			enum VertexLayout
+			{
+				VL_DEFAULT,
+				VL_PACKED,
+				VL_RECT
+			};
+
 			bool					 mInitialized;
+			VertexLayout			 mVertexLayout;
 			VertexElement2Vec mVertexElements;
+			VertexElement2Vec mPackedVertexElements;
+			VertexElement2Vec mRectVertexElements;
 
 			const String ImguiMovableType = "IMGUI";
         };
 
+        struct RectInstance
+        {
+            ImVec2 min, max;
+            float rounding, borderSize;
+            ImU32 fillCol, borderCol;
+        };
+        struct RectBatch
+        {
+            size_t first, count;
+        };
+
+        /// marks draw commands holding a RectBatch
+        static void rectCallback(const ImDrawList* parent_list, const ImDrawCmd* cmd);
+        void buildRectVertices(const RectBatch& batch, ImVector<ImDrawVertRect>& vtxBuf, ImVector<ImDrawIdx>& idxBuf);
+
         void createFontTexture();
         void createMaterial();
 
 		SceneManager*				mSceneMgr;
+		HlmsImgui*					mHlms;
+		HlmsTypes					mHlmsType;
+		bool						mOwnsHlms;
+		String						mHlmsFolder;
 		uint32 mScreenWidth, mScreenHeight;
         ImGUIRenderable             *mRenderables[MAX_NUM_RENDERABLES] = { 0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0 };
         TextureGpu*                  mFontTex;
 		void(*mDisplayFunction)(bool*);
 
         bool                        mFrameEnded;
+        bool                        mPackedVertices;
+        int                         mDistanceFieldSpread;
+        ImguiRemoteServer*          mRemote;
+        bool                        mOcclusionCulling;
+        CullStats                   mCullStats;
+        bool                        mDroppedDrawsLogged;
 		Ogre::VertexBufferPacked *vertexBuffer[MAX_NUM_RENDERABLES] = { 0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0 };
 
+		Ogre::VertexBufferPacked *mRectVertexBuffers[MAX_NUM_RENDERABLES] = { 0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0 };
+        std::vector<RectInstance>   mRectInstances;
+        std::vector<RectBatch>      mRectBatches;
+
         typedef std::vector<ImWchar> CodePointRange;
         std::vector<CodePointRange> mCodePointRanges;
     };
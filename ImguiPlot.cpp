@@ -0,0 +1,252 @@
+#include "ImguiPlot.h"
+
+#include <imgui_internal.h>
+
+#include <algorithm>
+#include <math.h>
+#include <string.h>
+
+using namespace Ogre;
+
+ImguiPlotSeries::ImguiPlotSeries(size_t capacity) : mHead(0)
+{
+    size_t n = 1;
+    while (n < capacity)
+        n <<= 1;
+    mSamples.resize(n, 0.0f);
+    mMask = n - 1;
+    mVisibleCount = n;
+
+    for (size_t size = n >> 1; size > 0; size >>= 1)
+        mLevels.push_back(std::vector<MinMax>(size));
+}
+
+void ImguiPlotSeries::clear()
+{
+    // stale pyramid entries are fine: a node is only queried once all of its samples were rewritten
+    mHead = 0;
+}
+
+void ImguiPlotSeries::append(const float* values, int values_count)
+{
+    if (values_count <= 0)
+        return;
+
+    size_t count = size_t(values_count);
+    if (count > mSamples.size())
+    {
+        // only the newest samples fit
+        mHead += count - mSamples.size();
+        values += count - mSamples.size();
+        count = mSamples.size();
+    }
+
+    size_t pos = size_t(mHead & mMask);
+    size_t tail = std::min(count, mSamples.size() - pos);
+    memcpy(&mSamples[pos], values, tail * sizeof(float));
+    updateLevels(pos, pos + tail);
+    if (count > tail)
+    {
+        memcpy(&mSamples[0], values + tail, (count - tail) * sizeof(float));
+        updateLevels(0, count - tail);
+    }
+    mHead += count;
+}
+
+void ImguiPlotSeries::updateLevels(size_t first, size_t last)
+{
+    for (size_t l = 0; l < mLevels.size() && first < last; l++)
+    {
+        first >>= 1;
+        last = (last + 1) >> 1;
+
+        std::vector<MinMax>& level = mLevels[l];
+        if (l == 0)
+        {
+            for (size_t i = first; i < last; i++)
+            {
+                level[i].min = std::min(mSamples[2 * i], mSamples[2 * i + 1]);
+                level[i].max = std::max(mSamples[2 * i], mSamples[2 * i + 1]);
+            }
+        }
+        else
+        {
+            const std::vector<MinMax>& below = mLevels[l - 1];
+            for (size_t i = first; i < last; i++)
+            {
+                level[i].min = std::min(below[2 * i].min, below[2 * i + 1].min);
+                level[i].max = std::max(below[2 * i].max, below[2 * i + 1].max);
+            }
+        }
+    }
+}
+
+void ImguiPlotSeries::queryRing(size_t first, size_t last, MinMax& result) const
+{
+    // bottom up segment tree walk: take the unpaired node at either end, then go one level up.
+    // the bulk of a wide range is covered by the few coarse levels matching its size
+    for (size_t l = 0; first < last; l++, first >>= 1, last >>= 1)
+    {
+        if (first & 1)
+        {
+            MinMax node = l ? mLevels[l - 1][first] : MinMax{mSamples[first], mSamples[first]};
+            result.min = std::min(result.min, node.min);
+            result.max = std::max(result.max, node.max);
+            first++;
+        }
+        if (last & 1)
+        {
+            last--;
+            MinMax node = l ? mLevels[l - 1][last] : MinMax{mSamples[last], mSamples[last]};
+            result.min = std::min(result.min, node.min);
+            result.max = std::max(result.max, node.max);
+        }
+    }
+}
+
+void ImguiPlotSeries::getRange(size_t first, size_t count, float& minValue, float& maxValue) const
+{
+    MinMax result = {FLT_MAX, -FLT_MAX};
+    count = std::min(count, getSize() - std::min(first, getSize()));
+
+    size_t pos = size_t((mHead - getSize() + first) & mMask);
+    size_t tail = std::min(count, mSamples.size() - pos);
+    queryRing(pos, pos + tail, result);
+    if (count > tail)
+        queryRing(0, count - tail, result);
+
+    minValue = result.min;
+    maxValue = result.max;
+}
+
+void ImguiPlotSeries::setVisibleCount(size_t count)
+{
+    mVisibleCount = std::max(std::min(count, mSamples.size()), size_t(2));
+}
+
+bool ImguiPlotSeries::plot(const char* label, const ImVec2& graphSize, float scaleMin, float scaleMax)
+{
+    ImGuiWindow* window = ImGui::GetCurrentWindow();
+    if (window->SkipItems)
+        return false;
+
+    const ImGuiStyle& style = ImGui::GetStyle();
+    ImVec2 size(graphSize.x > 0 ? graphSize.x : ImGui::CalcItemWidth(),
+                graphSize.y > 0 ? graphSize.y : ImGui::GetFrameHeight() * 4);
+
+    ImGui::PushID(label);
+    ImGui::InvisibleButton("##plot", size);
+    ImGui::PopID();
+    bool hovered = ImGui::IsItemHovered();
+    // the wheel zooms, so keep the parent window from scrolling while hovered
+#if IMGUI_VERSION_NUM >= 18900
+    ImGui::SetItemKeyOwner(ImGuiKey_MouseWheelY);
+#elif IMGUI_VERSION_NUM >= 18500
+    if (hovered)
+        ImGui::SetItemUsingMouseWheel();
+#endif
+    ImVec2 frameMin = ImGui::GetItemRectMin();
+    ImVec2 frameMax = ImGui::GetItemRectMax();
+
+    const char* labelEnd = ImGui::FindRenderedTextEnd(label);
+    if (labelEnd != label)
+    {
+        ImGui::SameLine(0, style.ItemInnerSpacing.x);
+        ImGui::TextUnformatted(label, labelEnd);
+    }
+
+    // zoom in/out by 25% per wheel step, starting from what is actually shown. zooming out adds at
+    // least one sample so a few visible samples do not round back to the same count
+    ImGuiIO& io = ImGui::GetIO();
+    if (hovered && io.MouseWheel != 0)
+    {
+        size_t shown = std::min(mVisibleCount, std::max(getSize(), size_t(2)));
+        float scaled = shown * powf(0.8f, io.MouseWheel);
+        setVisibleCount(io.MouseWheel < 0 ? std::max(shown + 1, size_t(ceilf(scaled))) : size_t(scaled));
+        io.MouseWheel = 0.0f;
+    }
+
+    ImGui::RenderFrame(frameMin, frameMax, ImGui::GetColorU32(ImGuiCol_FrameBg), true, style.FrameRounding);
+
+    size_t visible = std::min(mVisibleCount, getSize());
+    if (visible < 2)
+        return hovered;
+    size_t first = getSize() - visible;
+
+    if (scaleMin == FLT_MAX || scaleMax == FLT_MAX)
+    {
+        float minValue, maxValue;
+        getRange(first, visible, minValue, maxValue);
+        if (scaleMin == FLT_MAX)
+            scaleMin = minValue;
+        if (scaleMax == FLT_MAX)
+            scaleMax = maxValue;
+    }
+    float scaleY = scaleMax > scaleMin ? 1.0f / (scaleMax - scaleMin) : 0.0f;
+
+    ImVec2 innerMin(frameMin.x + style.FramePadding.x, frameMin.y + style.FramePadding.y);
+    ImVec2 innerMax(frameMax.x - style.FramePadding.x, frameMax.y - style.FramePadding.y);
+    float height = innerMax.y - innerMin.y;
+    size_t columns = std::max(size_t(innerMax.x - innerMin.x), size_t(1));
+
+    mPoints.resize(0);
+    if (visible <= 2 * columns)
+    {
+        // zoomed in: every sample is a point
+        float stepX = (innerMax.x - innerMin.x) / (visible - 1);
+        for (size_t i = 0; i < visible; i++)
+        {
+            float y = (getSample(first + i) - scaleMin) * scaleY;
+            mPoints.push_back(ImVec2(innerMin.x + i * stepX, innerMax.y - y * height));
+        }
+    }
+    else
+    {
+        // zoomed out: min and max of the samples under each pixel column, ordered so the line
+        // continues from the end closest to the previous column
+        float prevY = 0;
+        for (size_t c = 0; c < columns; c++)
+        {
+            size_t begin = size_t(uint64(c) * visible / columns);
+            size_t end = size_t(uint64(c + 1) * visible / columns);
+            float minValue, maxValue;
+            getRange(first + begin, end - begin, minValue, maxValue);
+
+            float x = innerMin.x + c + 0.5f;
+            float yMin = innerMax.y - (minValue - scaleMin) * scaleY * height;
+            float yMax = innerMax.y - (maxValue - scaleMin) * scaleY * height;
+            bool minFirst = c == 0 || fabsf(prevY - yMin) < fabsf(prevY - yMax);
+            mPoints.push_back(ImVec2(x, minFirst ? yMin : yMax));
+            mPoints.push_back(ImVec2(x, minFirst ? yMax : yMin));
+            prevY = mPoints.back().y;
+        }
+    }
+
+    ImDrawList* drawList = window->DrawList;
+    drawList->PushClipRect(innerMin, innerMax, true);
+    drawList->AddPolyline(mPoints.Data, mPoints.Size,
+                          ImGui::GetColorU32(hovered ? ImGuiCol_PlotLinesHovered : ImGuiCol_PlotLines), false, 1.0f);
+    drawList->PopClipRect();
+
+    if (hovered && io.MousePos.x >= innerMin.x && io.MousePos.x < innerMax.x)
+    {
+        float t = (io.MousePos.x - innerMin.x) / (innerMax.x - innerMin.x);
+        size_t begin = std::min(size_t(t * visible), visible - 1);
+        size_t end = size_t((io.MousePos.x + 1 - innerMin.x) / (innerMax.x - innerMin.x) * visible);
+        end = std::min(std::max(end, begin + 1), visible);
+        uint64 index = mHead - getSize() + first + begin;
+        if (end - begin == 1)
+        {
+            ImGui::SetTooltip("%llu: %8.4g", (unsigned long long)index, getSample(first + begin));
+        }
+        else
+        {
+            float minValue, maxValue;
+            getRange(first + begin, end - begin, minValue, maxValue);
+            ImGui::SetTooltip("%llu-%llu: %8.4g .. %8.4g", (unsigned long long)index,
+                              (unsigned long long)(index + end - begin - 1), minValue, maxValue);
+        }
+    }
+
+    return hovered;
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <imgui/imgui.h>
+
+#include <OgrePrerequisites.h>
+
+#include <float.h>
+#include <stddef.h>
+#include <vector>
+
+namespace Ogre
+{
+    /// time series kept in a ring buffer, with a min/max pyramid over it.
+    /// level L of the pyramid holds the min and max of every 2^L consecutive samples and is updated
+    /// as samples are appended, so drawing costs about two points per pixel column no matter how
+    /// many samples are visible
+    class ImguiPlotSeries
+    {
+    public:
+        /// @param capacity number of samples kept, rounded up to a power of two
+        explicit ImguiPlotSeries(size_t capacity);
+
+        /// once the buffer is full, the oldest samples are overwritten
+        void append(float value) { append(&value, 1); }
+        void append(const float* values, int values_count);
+        void clear();
+
+        /// number of samples stored, at most getCapacity()
+        size_t getSize() const { return mHead < mSamples.size() ? size_t(mHead) : mSamples.size(); }
+        size_t getCapacity() const { return mSamples.size(); }
+        /// samples appended since construction or clear(), including overwritten ones
+        uint64 getTotalCount() const { return mHead; }
+
+        /// sample i, 0 being the oldest one stored
+        float getSample(size_t i) const { return mSamples[(mHead - getSize() + i) & mMask]; }
+        /// min and max of the samples [first, first + count) in O(log count)
+        void getRange(size_t first, size_t count, float& minValue, float& maxValue) const;
+
+        /// number of most recent samples plot() shows. the mouse wheel changes it while the plot is hovered
+        void setVisibleCount(size_t count);
+        size_t getVisibleCount() const { return mVisibleCount; }
+
+        /// draw the visible samples like ImGui::PlotLines(). scaleMin/scaleMax default to the visible range
+        /// @return true while hovered
+        bool plot(const char* label, const ImVec2& graphSize = ImVec2(0, 0), float scaleMin = FLT_MAX,
+                  float scaleMax = FLT_MAX);
+
+    private:
+        struct MinMax
+        {
+            float min, max;
+        };
+
+        /// recompute the pyramid above the samples [first, last) of the ring
+        void updateLevels(size_t first, size_t last);
+        /// min/max over the ring positions [first, last), which must not wrap
+        void queryRing(size_t first, size_t last, MinMax& result) const;
+
+        std::vector<float>  mSamples;
+        /// mLevels[L - 1] is level L, with getCapacity() >> L entries
+        std::vector<std::vector<MinMax> > mLevels;
+        size_t              mMask;
+        uint64              mHead; ///< total samples appended, the next one goes to mHead & mMask
+        size_t              mVisibleCount;
+
+        ImVector<ImVec2>    mPoints;
+    };
+}
@@ -0,0 +1,201 @@
+#include "ImguiRemote.h"
+#include "ImguiManager.h"
+
+#include <OgreLogManager.h>
+#include <OgreStringConverter.h>
+
+#include <chrono>
+#include <string.h>
+
+using namespace Ogre;
+using namespace ImguiRemote;
+
+static double now()
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+ImguiRemoteServer::ImguiRemoteServer(uint16 port, const String& bindAddress)
+    : mFrameId(0), mBandwidthStart(now()), mBandwidthBytes(0)
+{
+    memset(&mStats, 0, sizeof(mStats));
+    memset(mSendTimes, 0, sizeof(mSendTimes));
+
+    String endpoint = bindAddress + ":" + StringConverter::toString(port);
+    if (mListenSocket.listen(port, bindAddress.c_str()))
+        LogManager::getSingleton().logMessage("ImguiRemote: listening on " + endpoint);
+    else
+        LogManager::getSingleton().logMessage("ImguiRemote: cannot listen on " + endpoint, LML_CRITICAL);
+}
+
+void ImguiRemoteServer::pollInput(InputListener* listener)
+{
+    if (mListenSocket.accept(mClient))
+    {
+        // a new viewer has no previous frame to apply deltas to
+        mCodec.reset();
+        sendFontAtlas();
+        LogManager::getSingleton().logMessage("ImguiRemote: viewer connected");
+    }
+
+    uint32_t type;
+    std::vector<uint8_t> payload;
+    while (mClient.receiveMessage(type, payload))
+    {
+        if (type == MSG_INPUT && payload.size() == sizeof(InputEvent))
+        {
+            InputEvent evt;
+            memcpy(&evt, payload.data(), sizeof(evt));
+            dispatchInput(evt, listener);
+        }
+        else if (type == MSG_ACK && payload.size() == sizeof(uint32_t))
+        {
+            uint32_t frameId;
+            memcpy(&frameId, payload.data(), sizeof(frameId));
+            mStats.latencyMs = float((now() - mSendTimes[frameId % 256]) * 1000.0);
+        }
+    }
+}
+
+void ImguiRemoteServer::dispatchInput(const InputEvent& evt, InputListener* listener)
+{
+    switch (evt.type)
+    {
+    case INPUT_MOUSE_MOVE:
+    case INPUT_MOUSE_WHEEL:
+    {
+        SDL_Event e;
+        memset(&e, 0, sizeof(e));
+        if (evt.type == INPUT_MOUSE_WHEEL)
+        {
+            e.type = SDL_MOUSEWHEEL;
+            e.wheel.y = evt.y;
+        }
+        else
+        {
+            e.type = SDL_MOUSEMOTION;
+            e.motion.x = evt.x;
+            e.motion.y = evt.y;
+        }
+        listener->mouseMoved(e);
+        break;
+    }
+    case INPUT_MOUSE_DOWN:
+    case INPUT_MOUSE_UP:
+    {
+        SDL_MouseButtonEvent e;
+        memset(&e, 0, sizeof(e));
+        e.type = evt.type == INPUT_MOUSE_DOWN ? SDL_MOUSEBUTTONDOWN : SDL_MOUSEBUTTONUP;
+        e.button = Uint8(evt.button);
+        e.x = evt.x;
+        e.y = evt.y;
+        if (evt.type == INPUT_MOUSE_DOWN)
+            listener->mousePressed(e, e.button);
+        else
+            listener->mouseReleased(e, e.button);
+        break;
+    }
+    case INPUT_KEY_DOWN:
+    case INPUT_KEY_UP:
+    {
+        SDL_KeyboardEvent e;
+        memset(&e, 0, sizeof(e));
+        e.type = evt.type == INPUT_KEY_DOWN ? SDL_KEYDOWN : SDL_KEYUP;
+        e.keysym.scancode = SDL_Scancode(evt.scancode);
+        e.keysym.sym = SDL_Keycode(evt.keycode);
+        e.keysym.mod = Uint16(evt.mod);
+        if (evt.type == INPUT_KEY_DOWN)
+            listener->keyPressed(e);
+        else
+            listener->keyReleased(e);
+        break;
+    }
+    case INPUT_TEXT:
+    {
+        SDL_TextInputEvent e;
+        memset(&e, 0, sizeof(e));
+        e.type = SDL_TEXTINPUT;
+        strncpy(e.text, evt.text, sizeof(e.text) - 1);
+        listener->textInput(e);
+        break;
+    }
+    }
+}
+
+void ImguiRemoteServer::sendFontAtlas()
+{
+    unsigned char* pixels;
+    int width, height;
+    ImGui::GetIO().Fonts->GetTexDataAsAlpha8(&pixels, &width, &height);
+
+    // read when sending, setDistanceFieldFont() may be called after setRemotePort()
+    int spread = ImguiManager::getSingleton().getDistanceFieldFont();
+    FontAtlasHeader header = {uint32_t(width), uint32_t(height), uint32_t(spread)};
+    mPayload.assign((const uint8*)&header, (const uint8*)(&header + 1));
+
+    // mostly empty space, which the codec run-length encodes
+    std::vector<std::vector<uint8_t> > chunks(spread ? 2 : 1);
+    chunks[0].assign(pixels, pixels + width * height);
+    if (spread)
+    {
+        // the red channel marks the texels holding distances
+        ImGui::GetIO().Fonts->GetTexDataAsRGBA32(&pixels, &width, &height);
+        chunks[1].resize(width * height);
+        for (int i = 0; i < width * height; i++)
+            chunks[1][i] = pixels[i * 4];
+    }
+    FrameCodec codec;
+    codec.encode(chunks, mPayload);
+
+    mClient.sendMessage(MSG_FONT_ATLAS, mPayload.data(), mPayload.size());
+}
+
+void ImguiRemoteServer::sendFrame(ImDrawData* drawData, ImTextureID fontTexId)
+{
+    if (!mClient.isOpen())
+        return;
+
+    if (mClient.pendingBytes() > 0)
+    {
+        // the next frame is encoded against the last one sent, so skipping is safe
+        mStats.framesSkipped++;
+        return;
+    }
+
+    mFrameId++;
+    FrameHeader header;
+    header.frameId = mFrameId;
+    header.latencyMs = mStats.latencyMs;
+    header.displayPos[0] = drawData->DisplayPos.x;
+    header.displayPos[1] = drawData->DisplayPos.y;
+    header.displaySize[0] = drawData->DisplaySize.x;
+    header.displaySize[1] = drawData->DisplaySize.y;
+    header.numDrawLists = uint32_t(drawData->CmdListsCount);
+
+    mChunks.resize(drawData->CmdListsCount);
+    for (int i = 0; i < drawData->CmdListsCount; i++)
+    {
+        serializeDrawList(drawData->CmdLists[i], fontTexId, mChunks[i]);
+        mStats.rawBytes += mChunks[i].size();
+    }
+
+    mPayload.assign((const uint8*)&header, (const uint8*)(&header + 1));
+    mCodec.encode(mChunks, mPayload);
+
+    uint64 sentBefore = mClient.getBytesSent() + mClient.pendingBytes();
+    mSendTimes[mFrameId % 256] = now();
+    mClient.sendMessage(MSG_FRAME, mPayload.data(), mPayload.size());
+    uint64 wireBytes = mClient.getBytesSent() + mClient.pendingBytes() - sentBefore;
+
+    mStats.framesSent++;
+    mStats.wireBytes += wireBytes;
+    mBandwidthBytes += wireBytes;
+
+    double t = now();
+    if (t - mBandwidthStart >= 1.0)
+    {
+        mStats.bytesPerSecond = float(mBandwidthBytes / (t - mBandwidthStart));
+        mBandwidthStart = t;
+        mBandwidthBytes = 0;
+    }
+}
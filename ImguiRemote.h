@@ -0,0 +1,56 @@
+#pragma once
+
+#include "ImguiRemoteProtocol.h"
+
+#include <OgrePrerequisites.h>
+
+class InputListener;
+
+namespace Ogre
+{
+    /// streams the rendered imgui frames to a RemoteViewer over TCP and feeds its input back.
+    /// only one viewer is served at a time
+    class ImguiRemoteServer
+    {
+    public:
+        struct Stats
+        {
+            uint64 framesSent;
+            uint64 framesSkipped; ///< dropped while the viewer was still receiving an older frame
+            uint64 rawBytes;      ///< serialized draw lists before delta encoding
+            uint64 wireBytes;     ///< bytes actually sent
+            float bytesPerSecond; ///< wire bandwidth over the last second
+            float latencyMs;      ///< frame sent -> presented by the viewer -> ack received
+        };
+
+        /// @param bindAddress interface to listen on. viewers can inject input, so only loopback by default
+        ImguiRemoteServer(uint16 port, const String& bindAddress = "127.0.0.1");
+
+        bool isListening() const { return mListenSocket.isOpen(); }
+        bool isConnected() const { return mClient.isOpen(); }
+
+        /// accept a waiting viewer and forward its input to listener. call before ImGui::NewFrame()
+        void pollInput(InputListener* listener);
+        /// send the frame, unless the viewer did not receive the previous one yet. call after ImGui::Render()
+        void sendFrame(ImDrawData* drawData, ImTextureID fontTexId);
+
+        const Stats& getStats() const { return mStats; }
+
+    private:
+        void sendFontAtlas();
+        void dispatchInput(const ImguiRemote::InputEvent& evt, InputListener* listener);
+
+        ImguiRemote::Socket     mListenSocket;
+        ImguiRemote::Socket     mClient;
+        ImguiRemote::FrameCodec mCodec;
+
+        uint32                  mFrameId;
+        double                  mSendTimes[256]; ///< indexed by frame id, to measure the round trip
+        Stats                   mStats;
+        double                  mBandwidthStart;
+        uint64                  mBandwidthBytes;
+
+        std::vector<std::vector<uint8> > mChunks;
+        std::vector<uint8>      mPayload;
+    };
+}
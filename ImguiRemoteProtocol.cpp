@@ -0,0 +1,400 @@
+#include "ImguiRemoteProtocol.h"
+
+#include <string.h>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+typedef int socklen_t;
+#define INVALID_SOCKET_VALUE ((intptr_t)INVALID_SOCKET)
+#define closeSocket closesocket
+#define wouldBlock() (WSAGetLastError() == WSAEWOULDBLOCK)
+#else
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <netdb.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#define INVALID_SOCKET_VALUE ((intptr_t)-1)
+#define closeSocket ::close
+#define wouldBlock() (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)
+#endif
+
+#ifdef MSG_NOSIGNAL
+#define SEND_FLAGS MSG_NOSIGNAL // report a closed peer as error instead of raising SIGPIPE
+#else
+#define SEND_FLAGS 0
+#endif
+
+using namespace ImguiRemote;
+
+namespace
+{
+    struct MessageHeader
+    {
+        uint32_t type;
+        uint32_t size;
+    };
+
+    template<typename T> void append(std::vector<uint8_t>& out, const T* data, size_t count)
+    {
+        const uint8_t* bytes = reinterpret_cast<const uint8_t*>(data);
+        out.insert(out.end(), bytes, bytes + count * sizeof(T));
+    }
+
+    template<typename T> bool read(const std::vector<uint8_t>& in, size_t& offset, T* data, size_t count)
+    {
+        size_t size = count * sizeof(T);
+        if(offset + size > in.size())
+            return false;
+        if(size)
+            memcpy(data, &in[offset], size);
+        offset += size;
+        return true;
+    }
+
+    void appendVarint(std::vector<uint8_t>& out, size_t value)
+    {
+        while(value >= 0x80)
+        {
+            out.push_back(uint8_t(value | 0x80));
+            value >>= 7;
+        }
+        out.push_back(uint8_t(value));
+    }
+
+    bool readVarint(const std::vector<uint8_t>& in, size_t& offset, size_t& value)
+    {
+        value = 0;
+        for(int shift = 0; offset < in.size() && shift < 64; shift += 7)
+        {
+            uint8_t byte = in[offset++];
+            value |= size_t(byte & 0x7F) << shift;
+            if(!(byte & 0x80))
+                return true;
+        }
+        return false;
+    }
+
+    /// XOR cur against prev (zero padded) and store it as pairs of (zero run, literal run)
+    void encodeChunk(const std::vector<uint8_t>& prev, const std::vector<uint8_t>& cur, std::vector<uint8_t>& out)
+    {
+        size_t i = 0;
+        size_t n = cur.size();
+        while(i < n)
+        {
+            size_t zeros = 0;
+            while(i + zeros < n && cur[i + zeros] == (i + zeros < prev.size() ? prev[i + zeros] : 0))
+                zeros++;
+            i += zeros;
+
+            // end the literal run once the data matches for a few bytes
+            size_t literals = 0;
+            size_t matching = 0;
+            while(i + literals < n && matching < 4)
+            {
+                size_t j = i + literals;
+                matching = cur[j] == (j < prev.size() ? prev[j] : 0) ? matching + 1 : 0;
+                literals++;
+            }
+            if(matching)
+                literals -= matching;
+
+            appendVarint(out, zeros);
+            appendVarint(out, literals);
+            for(size_t j = i; j < i + literals; j++)
+                out.push_back(cur[j] ^ (j < prev.size() ? prev[j] : 0));
+            i += literals;
+        }
+    }
+
+    bool decodeChunk(const std::vector<uint8_t>& prev, const std::vector<uint8_t>& in, size_t& offset,
+                     size_t rawSize, std::vector<uint8_t>& cur)
+    {
+        cur.resize(rawSize);
+        size_t i = 0;
+        while(i < rawSize)
+        {
+            size_t zeros, literals;
+            if(!readVarint(in, offset, zeros) || !readVarint(in, offset, literals))
+                return false;
+            // an empty pair would never advance, i.e. a malformed frame would hang the decoder
+            if(zeros + literals == 0 || i + zeros + literals > rawSize || offset + literals > in.size())
+                return false;
+
+            for(size_t end = i + zeros; i < end; i++)
+                cur[i] = i < prev.size() ? prev[i] : 0;
+            for(size_t end = i + literals; i < end; i++)
+                cur[i] = in[offset++] ^ (i < prev.size() ? prev[i] : 0);
+        }
+        return true;
+    }
+}
+
+void ImguiRemote::serializeDrawList(const ImDrawList* drawList, ImTextureID fontTexId, std::vector<uint8_t>& out)
+{
+    std::vector<DrawCmd> cmds;
+    cmds.reserve(drawList->CmdBuffer.Size);
+    for(int i = 0; i < drawList->CmdBuffer.Size; i++)
+    {
+        const ImDrawCmd& src = drawList->CmdBuffer[i];
+        if(src.UserCallback != NULL || src.ElemCount == 0)
+            continue;
+
+        DrawCmd cmd;
+        cmd.clipRect[0] = src.ClipRect.x;
+        cmd.clipRect[1] = src.ClipRect.y;
+        cmd.clipRect[2] = src.ClipRect.z;
+        cmd.clipRect[3] = src.ClipRect.w;
+        cmd.elemCount = src.ElemCount;
+        cmd.fontTexture = src.TextureId == 0 || src.TextureId == fontTexId;
+        cmds.push_back(cmd);
+    }
+
+    uint32_t counts[3] = {uint32_t(drawList->VtxBuffer.Size), uint32_t(drawList->IdxBuffer.Size),
+                          uint32_t(cmds.size())};
+    out.clear();
+    append(out, counts, 3);
+    append(out, drawList->VtxBuffer.Data, drawList->VtxBuffer.Size);
+    append(out, drawList->IdxBuffer.Data, drawList->IdxBuffer.Size);
+    append(out, cmds.data(), cmds.size());
+}
+
+bool ImguiRemote::deserializeDrawList(const std::vector<uint8_t>& in, DrawList& out)
+{
+    size_t offset = 0;
+    uint32_t counts[3];
+    if(!read(in, offset, counts, 3))
+        return false;
+    // check the counts before allocating anything for them
+    uint64_t size = uint64_t(counts[0]) * sizeof(ImDrawVert) + uint64_t(counts[1]) * sizeof(ImDrawIdx) +
+                    uint64_t(counts[2]) * sizeof(DrawCmd);
+    if(size > in.size() - offset)
+        return false;
+
+    out.vtx.resize(counts[0]);
+    out.idx.resize(counts[1]);
+    out.cmds.resize(counts[2]);
+    return read(in, offset, out.vtx.data(), out.vtx.size()) &&
+           read(in, offset, out.idx.data(), out.idx.size()) &&
+           read(in, offset, out.cmds.data(), out.cmds.size());
+}
+//-----------------------------------------------------------------------------------
+void FrameCodec::encode(const std::vector<std::vector<uint8_t> >& chunks, std::vector<uint8_t>& out)
+{
+    mPrevChunks.resize(chunks.size());
+    for(size_t i = 0; i < chunks.size(); i++)
+    {
+        appendVarint(out, chunks[i].size());
+        encodeChunk(mPrevChunks[i], chunks[i], out);
+        mPrevChunks[i] = chunks[i];
+    }
+}
+
+bool FrameCodec::decode(const std::vector<uint8_t>& in, size_t offset, std::vector<std::vector<uint8_t> >& chunks)
+{
+    mPrevChunks.resize(chunks.size());
+    for(size_t i = 0; i < chunks.size(); i++)
+    {
+        size_t rawSize;
+        if(!readVarint(in, offset, rawSize) || rawSize > MAX_MESSAGE_SIZE || !decodeChunk(mPrevChunks[i], in, offset, rawSize, chunks[i]))
+            return false;
+        mPrevChunks[i] = chunks[i];
+    }
+    return true;
+}
+//-----------------------------------------------------------------------------------
+Socket::Socket() : mSocket(INVALID_SOCKET_VALUE), mBytesSent(0), mBytesReceived(0)
+{
+#ifdef _WIN32
+    static bool initialized = false;
+    if(!initialized)
+    {
+        WSADATA wsaData;
+        WSAStartup(MAKEWORD(2, 2), &wsaData);
+        initialized = true;
+    }
+#endif
+}
+Socket::~Socket()
+{
+    close();
+}
+
+bool Socket::isOpen() const
+{
+    return mSocket != INVALID_SOCKET_VALUE;
+}
+
+void Socket::close()
+{
+    if(isOpen())
+        closeSocket(mSocket);
+    mSocket = INVALID_SOCKET_VALUE;
+    mSendBuf.clear();
+    mRecvBuf.clear();
+}
+
+void Socket::setNonBlocking()
+{
+#ifdef _WIN32
+    u_long mode = 1;
+    ioctlsocket(mSocket, FIONBIO, &mode);
+#else
+    fcntl(mSocket, F_SETFL, fcntl(mSocket, F_GETFL, 0) | O_NONBLOCK);
+#endif
+    // small messages must not wait for more data
+    int noDelay = 1;
+    setsockopt(mSocket, IPPROTO_TCP, TCP_NODELAY, (const char*)&noDelay, sizeof(noDelay));
+}
+
+namespace
+{
+    bool resolve(const char* host, uint16_t port, sockaddr_in& addr)
+    {
+        addrinfo hints;
+        memset(&hints, 0, sizeof(hints));
+        hints.ai_family = AF_INET;
+        hints.ai_socktype = SOCK_STREAM;
+        addrinfo* result = NULL;
+        if(getaddrinfo(host, NULL, &hints, &result) != 0 || !result)
+            return false;
+
+        addr = *(sockaddr_in*)result->ai_addr;
+        addr.sin_port = htons(port);
+        freeaddrinfo(result);
+        return true;
+    }
+}
+
+bool Socket::listen(uint16_t port, const char* bindAddress)
+{
+    close();
+    sockaddr_in addr;
+    if(!resolve(bindAddress, port, addr))
+        return false;
+
+    mSocket = ::socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if(!isOpen())
+        return false;
+
+    int reuse = 1;
+    setsockopt(mSocket, SOL_SOCKET, SO_REUSEADDR, (const char*)&reuse, sizeof(reuse));
+
+    if(::bind(mSocket, (sockaddr*)&addr, sizeof(addr)) != 0 || ::listen(mSocket, 1) != 0)
+    {
+        close();
+        return false;
+    }
+    setNonBlocking();
+    return true;
+}
+
+bool Socket::accept(Socket& client)
+{
+    if(!isOpen())
+        return false;
+
+    intptr_t s = (intptr_t)::accept(mSocket, NULL, NULL);
+    if(s == INVALID_SOCKET_VALUE)
+        return false;
+
+    client.close();
+    client.mSocket = s;
+    client.setNonBlocking();
+    return true;
+}
+
+bool Socket::connect(const char* host, uint16_t port)
+{
+    close();
+    sockaddr_in addr;
+    if(!resolve(host, port, addr))
+        return false;
+
+    mSocket = ::socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if(!isOpen())
+        return false;
+    if(::connect(mSocket, (sockaddr*)&addr, sizeof(addr)) != 0)
+    {
+        close();
+        return false;
+    }
+    setNonBlocking();
+    return true;
+}
+
+void Socket::sendMessage(uint32_t type, const void* data, size_t size)
+{
+    if(!isOpen())
+        return;
+
+    MessageHeader header = {type, uint32_t(size)};
+    append(mSendBuf, &header, 1);
+    append(mSendBuf, (const uint8_t*)data, size);
+    flush();
+}
+
+void Socket::flush()
+{
+    size_t sent = 0;
+    while(sent < mSendBuf.size())
+    {
+        int n = ::send(mSocket, (const char*)&mSendBuf[sent], int(mSendBuf.size() - sent), SEND_FLAGS);
+        if(n <= 0)
+        {
+            if(n < 0 && wouldBlock())
+                break;
+            close();
+            return;
+        }
+        sent += n;
+    }
+    mBytesSent += sent;
+    mSendBuf.erase(mSendBuf.begin(), mSendBuf.begin() + sent);
+}
+
+bool Socket::receiveMessage(uint32_t& type, std::vector<uint8_t>& payload)
+{
+    if(isOpen())
+        flush();
+
+    char buf[16 * 1024];
+    while(isOpen())
+    {
+        int n = ::recv(mSocket, buf, sizeof(buf), 0);
+        if(n > 0)
+        {
+            mBytesReceived += n;
+            mRecvBuf.insert(mRecvBuf.end(), buf, buf + n);
+            continue;
+        }
+        if(n < 0 && wouldBlock())
+            break;
+        // peer closed the connection or an error occurred. still hand out what already arrived
+        closeSocket(mSocket);
+        mSocket = INVALID_SOCKET_VALUE;
+        break;
+    }
+
+    MessageHeader header;
+    if(mRecvBuf.size() < sizeof(header))
+        return false;
+    memcpy(&header, &mRecvBuf[0], sizeof(header));
+    if(header.size > MAX_MESSAGE_SIZE)
+    {
+        // do not buffer whatever a broken or hostile peer announces
+        close();
+        return false;
+    }
+    if(mRecvBuf.size() < sizeof(header) + header.size)
+        return false;
+
+    type = header.type;
+    payload.assign(mRecvBuf.begin() + sizeof(header), mRecvBuf.begin() + sizeof(header) + header.size);
+    mRecvBuf.erase(mRecvBuf.begin(), mRecvBuf.begin() + sizeof(header) + header.size);
+    return true;
+}
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <imgui/imgui.h>
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+/// wire protocol shared by ImguiRemoteServer and the RemoteViewer.
+/// it only depends on imgui types, so the viewer does not need Ogre.
+/// all values are sent in host byte order, i.e. little endian on every supported platform
+namespace ImguiRemote
+{
+    static const uint16_t DEFAULT_PORT = 7007;
+    /// larger messages, and chunks decoding to more than this, are treated as malformed
+    static const uint32_t MAX_MESSAGE_SIZE = 64 * 1024 * 1024;
+
+    enum MessageType
+    {
+        MSG_FONT_ATLAS = 1, ///< server -> viewer: FontAtlasHeader + alpha8 pixels [+ distance mask]
+        MSG_FRAME,          ///< server -> viewer: FrameHeader + delta encoded draw lists
+        MSG_INPUT,          ///< viewer -> server: InputEvent
+        MSG_ACK             ///< viewer -> server: uint32_t frame id, once the frame was presented
+    };
+
+    struct FontAtlasHeader
+    {
+        uint32_t width, height;
+        uint32_t distanceFieldSpread; ///< 0 for a coverage atlas. otherwise a mask marking the distance texels follows
+    };
+
+    struct FrameHeader
+    {
+        uint32_t frameId;
+        float latencyMs; ///< round trip last measured by the server
+        float displayPos[2];
+        float displaySize[2];
+        uint32_t numDrawLists;
+    };
+
+    enum InputType
+    {
+        INPUT_MOUSE_MOVE = 1, ///< x, y
+        INPUT_MOUSE_WHEEL,    ///< y
+        INPUT_MOUSE_DOWN,     ///< x, y, button (SDL numbering)
+        INPUT_MOUSE_UP,
+        INPUT_KEY_DOWN,       ///< scancode, keycode, mod (SDL values)
+        INPUT_KEY_UP,
+        INPUT_TEXT            ///< text
+    };
+
+    struct InputEvent
+    {
+        uint32_t type;
+        int32_t x, y;
+        int32_t button;
+        int32_t scancode, keycode, mod;
+        char text[32];
+    };
+
+    struct DrawCmd
+    {
+        float clipRect[4];
+        uint32_t elemCount;
+        uint32_t fontTexture; ///< 0 if a user texture was bound, which cannot be streamed
+    };
+
+    struct DrawList
+    {
+        std::vector<ImDrawVert> vtx;
+        std::vector<ImDrawIdx> idx;
+        std::vector<DrawCmd> cmds;
+    };
+
+    /// flatten a draw list. user callbacks are not streamed
+    void serializeDrawList(const ImDrawList* drawList, ImTextureID fontTexId, std::vector<uint8_t>& out);
+    bool deserializeDrawList(const std::vector<uint8_t>& in, DrawList& out);
+
+    /// encodes every draw list as XOR against the same list of the previous frame and compresses
+    /// the resulting zero runs. a UI that does not change costs a few bytes per list.
+    /// the server and the viewer each keep one instance per connection
+    class FrameCodec
+    {
+    public:
+        void reset() { mPrevChunks.clear(); }
+
+        void encode(const std::vector<std::vector<uint8_t> >& chunks, std::vector<uint8_t>& out);
+        /// reads chunks.size() chunks starting at in[offset]
+        bool decode(const std::vector<uint8_t>& in, size_t offset, std::vector<std::vector<uint8_t> >& chunks);
+
+    private:
+        std::vector<std::vector<uint8_t> > mPrevChunks;
+    };
+
+    /// non-blocking, message framed TCP socket
+    class Socket
+    {
+    public:
+        Socket();
+        ~Socket();
+
+        /// only hosts that can reach bindAddress may connect, the default accepts local viewers only.
+        /// "0.0.0.0" listens on every interface
+        bool listen(uint16_t port, const char* bindAddress = "127.0.0.1");
+        /// returns false if no client is waiting
+        bool accept(Socket& client);
+        /// blocks until connected
+        bool connect(const char* host, uint16_t port);
+
+        bool isOpen() const;
+        void close();
+
+        /// queue a message and send as much as the socket accepts right now
+        void sendMessage(uint32_t type, const void* data, size_t size);
+        /// bytes still waiting in the send queue, e.g. because the peer reads slower than we send
+        size_t pendingBytes() const { return mSendBuf.size(); }
+        /// returns false if no complete message arrived yet.
+        /// a header announcing more than MAX_MESSAGE_SIZE bytes closes the connection
+        bool receiveMessage(uint32_t& type, std::vector<uint8_t>& payload);
+
+        uint64_t getBytesSent() const { return mBytesSent; }
+        uint64_t getBytesReceived() const { return mBytesReceived; }
+
+    private:
+        Socket(const Socket&);
+        Socket& operator=(const Socket&);
+
+        void setNonBlocking();
+        void flush();
+
+        intptr_t mSocket;
+        std::vector<uint8_t> mSendBuf;
+        std::vector<uint8_t> mRecvBuf;
+        uint64_t mBytesSent, mBytesReceived;
+    };
+}
@@ -7,6 +7,7 @@
 #include "OgreAdvancedRenderControls.h"
 #include "OgreCameraMan.h"
 #include "ImguiManager.h"
+#include "ImguiPlot.h"
 %}
 
 %include std_string.i
@@ -32,6 +33,77 @@
 %apply bool* INOUT { bool* p_open };
 %apply float* INOUT { float* v };
 %apply int* INOUT { int* v };
+
+#ifdef SWIGPYTHON
+// pass objects supporting the buffer protocol (numpy arrays, array.array, memoryview) without copying
+%{
+static bool OgreImgui_getBuffer(PyObject* obj, Py_buffer* view, int flags, char type, Py_ssize_t minItems)
+{
+    if (PyObject_GetBuffer(obj, view, flags | PyBUF_C_CONTIGUOUS | PyBUF_FORMAT) != 0)
+        return false;
+
+    // accept native and explicit little endian formats only, e.g. "f", "@f", "<f"
+    const char* fmt = view->format ? view->format : "B";
+    if (fmt[0] == '@' || fmt[0] == '=' || fmt[0] == '<')
+        fmt++;
+    // numpy reports int32 as 'l' where long is 32 bit
+    bool sameType = fmt[0] == type || (type == 'i' && fmt[0] == 'l');
+    if (!sameType || fmt[1] != '\0' || view->itemsize != 4 || view->len / 4 < minItems)
+    {
+        PyErr_Format(PyExc_TypeError, "expected a C contiguous buffer of at least %d '%c' items of 4 bytes",
+                     int(minItems), type);
+        PyBuffer_Release(view);
+        return false;
+    }
+    return true;
+}
+%}
+
+// PlotLines, PlotHistogram
+%typemap(in) (const float* values, int values_count) (Py_buffer view, int viewAcquired = 0) {
+    if (!OgreImgui_getBuffer($input, &view, PyBUF_SIMPLE, 'f', 0))
+        SWIG_fail;
+    viewAcquired = 1;
+    $1 = (float*)view.buf;
+    $2 = int(view.len / sizeof(float));
+}
+%typemap(typecheck, precedence=SWIG_TYPECHECK_FLOAT_ARRAY) (const float* values, int values_count) {
+    $1 = PyObject_CheckBuffer($input) ? 1 : 0;
+}
+%typemap(freearg) (const float* values, int values_count) {
+    if (viewAcquired$argnum)
+        PyBuffer_Release(&view$argnum);
+}
+// values_count is derived from the buffer assuming packed floats, so the stride is not exposed
+%typemap(in, numinputs=0) int stride "$1 = sizeof(float);"
+// imgui reads values[(i + values_offset) % values_count], which is only in bounds for offset >= 0
+%typemap(check) int values_offset {
+    if ($1 < 0)
+        SWIG_exception(SWIG_ValueError, "values_offset must not be negative");
+}
+
+// SliderFloat3, DragInt2, ColorEdit4, ... update the buffer in place
+%define WRITABLE_BUFFER(TYPE, NAME, CODE)
+%typemap(in) TYPE NAME[ANY] (Py_buffer view, int viewAcquired = 0) {
+    if (!OgreImgui_getBuffer($input, &view, PyBUF_WRITABLE, CODE, $1_dim0))
+        SWIG_fail;
+    viewAcquired = 1;
+    $1 = (TYPE*)view.buf;
+}
+%typemap(typecheck, precedence=SWIG_TYPECHECK_POINTER) TYPE NAME[ANY] {
+    $1 = PyObject_CheckBuffer($input) ? 1 : 0;
+}
+%typemap(freearg) TYPE NAME[ANY] {
+    if (viewAcquired$argnum)
+        PyBuffer_Release(&view$argnum);
+}
+%enddef
+
+WRITABLE_BUFFER(float, v, 'f')
+WRITABLE_BUFFER(int, v, 'i')
+WRITABLE_BUFFER(float, col, 'f')
+#endif
+
 %include "imgui.h"
 
 #ifdef SWIGPYTHON
@@ -42,4 +114,33 @@
 #endif
 
 /// Ogre
-%include "ImguiManager.h"
\ No newline at end of file
+#ifdef SWIGPYTHON
+// render() does not call back into python, so other python threads may run meanwhile
+%exception Ogre::ImguiManager::render {
+    PyThreadState* _save = PyEval_SaveThread();
+    try
+    {
+        $action
+    }
+    catch (const std::exception& e)
+    {
+        PyEval_RestoreThread(_save);
+        SWIG_exception(SWIG_RuntimeError, e.what());
+    }
+    PyEval_RestoreThread(_save);
+}
+#endif
+
+%include "ImguiManager.h"
+%include "ImguiPlot.h"
+
+#ifdef SWIGPYTHON
+%pythoncode
+%{
+    # an installed module finds the Hlms templates next to it, see python/CMakeLists.txt
+    import os as _os
+    _resources = _os.path.join(_os.path.dirname(_os.path.abspath(__file__)), "OgreImgui_resources", "")
+    if _os.path.isdir(_os.path.join(_resources, "Hlms", "Imgui")):
+        ImguiManager.getSingleton().setHlmsFolder(_resources)
+%}
+#endif
\ No newline at end of file
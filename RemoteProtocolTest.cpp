@@ -0,0 +1,201 @@
+// loopback test of the remote UI protocol: FrameCodec round trips and Socket messaging on 127.0.0.1
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <thread>
+
+#include "ImguiRemoteProtocol.h"
+
+using namespace ImguiRemote;
+
+#define CHECK(cond)                                                                  \
+    do                                                                               \
+    {                                                                                \
+        if(!(cond))                                                                  \
+        {                                                                            \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            return false;                                                            \
+        }                                                                            \
+    } while(0)
+
+typedef std::vector<std::vector<uint8_t> > Chunks;
+
+static bool testCodec()
+{
+    FrameCodec encoder, decoder;
+    Chunks chunks(3);
+    srand(42);
+    for(int frame = 0; frame < 200; frame++)
+    {
+        for(size_t c = 0; c < chunks.size(); c++)
+        {
+            // grow, shrink and sparsely modify the chunks like changing draw lists would
+            if(rand() % 10 == 0)
+                chunks[c].resize(rand() % 5000);
+            for(int n = rand() % 20; n > 0 && !chunks[c].empty(); n--)
+                chunks[c][rand() % chunks[c].size()] = uint8_t(rand());
+        }
+
+        std::vector<uint8_t> encoded;
+        encoder.encode(chunks, encoded);
+
+        Chunks decoded(chunks.size());
+        CHECK(decoder.decode(encoded, 0, decoded));
+        CHECK(decoded == chunks);
+    }
+
+    // an unchanged frame costs a few bytes per chunk
+    std::vector<uint8_t> encoded;
+    encoder.encode(chunks, encoded);
+    CHECK(encoded.size() <= chunks.size() * 8);
+    Chunks decoded(chunks.size());
+    CHECK(decoder.decode(encoded, 0, decoded));
+    CHECK(decoded == chunks);
+
+    // truncated and malformed input must fail instead of hanging or reading past the end
+    Chunks one(1, std::vector<uint8_t>(100, 7));
+    FrameCodec fresh;
+    encoded.clear();
+    fresh.encode(one, encoded);
+    for(size_t size = 0; size < encoded.size(); size++)
+    {
+        FrameCodec codec;
+        std::vector<uint8_t> truncated(encoded.begin(), encoded.begin() + size);
+        Chunks out(1);
+        CHECK(!codec.decode(truncated, 0, out));
+    }
+    const uint8_t emptyRuns[] = {10, 0, 0, 0, 0};
+    FrameCodec codec;
+    Chunks out(1);
+    CHECK(!codec.decode(std::vector<uint8_t>(emptyRuns, emptyRuns + sizeof(emptyRuns)), 0, out));
+
+    // a chunk claiming to decode to more than a message may hold is rejected before allocating it
+    std::vector<uint8_t> huge;
+    size_t rawSize = size_t(MAX_MESSAGE_SIZE) + 1;
+    while(rawSize >= 0x80)
+    {
+        huge.push_back(uint8_t(rawSize | 0x80));
+        rawSize >>= 7;
+    }
+    huge.push_back(uint8_t(rawSize));
+    huge.push_back(0);
+    huge.push_back(0);
+    CHECK(!codec.decode(huge, 0, out));
+
+    // draw list counts are checked against the payload
+    const uint32_t counts[3] = {0x10000000, 0x10000000, 0x10000000};
+    std::vector<uint8_t> list((const uint8_t*)counts, (const uint8_t*)(counts + 3));
+    DrawList drawList;
+    CHECK(!deserializeDrawList(list, drawList));
+
+    return true;
+}
+
+/// poll until a message arrives or a second passed
+static bool receive(Socket& socket, uint32_t& type, std::vector<uint8_t>& payload)
+{
+    for(int i = 0; i < 1000; i++)
+    {
+        if(socket.receiveMessage(type, payload))
+            return true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return false;
+}
+
+/// connect client to a server listening on a free loopback port and accept it as peer
+static bool connectLoopback(Socket& server, Socket& client, Socket& peer)
+{
+    uint16_t port = 0;
+    for(uint16_t p = 27007; p < 27107 && !port; p++)
+    {
+        if(server.listen(p, "127.0.0.1"))
+            port = p;
+    }
+    CHECK(port != 0);
+    CHECK(client.connect("127.0.0.1", port));
+
+    bool accepted = false;
+    for(int i = 0; i < 1000 && !accepted; i++)
+    {
+        accepted = server.accept(peer);
+        if(!accepted)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    CHECK(accepted);
+    return true;
+}
+
+static bool testSocket()
+{
+    Socket server, client, peer;
+    CHECK(connectLoopback(server, client, peer));
+
+    // small message one way, a large one the other, which needs several partial sends
+    uint32_t ack = 1234;
+    client.sendMessage(MSG_ACK, &ack, sizeof(ack));
+
+    std::vector<uint8_t> big(4 * 1024 * 1024);
+    for(size_t i = 0; i < big.size(); i++)
+        big[i] = uint8_t(i * 31);
+    peer.sendMessage(MSG_FRAME, big.data(), big.size());
+
+    uint32_t type;
+    std::vector<uint8_t> payload;
+    CHECK(receive(peer, type, payload));
+    CHECK(type == MSG_ACK && payload.size() == sizeof(ack) && memcmp(payload.data(), &ack, sizeof(ack)) == 0);
+
+    bool gotFrame = false;
+    for(int i = 0; i < 5000 && !gotFrame; i++)
+    {
+        // the send queue is only flushed when the socket is polled
+        uint32_t ignoredType;
+        std::vector<uint8_t> ignored;
+        peer.receiveMessage(ignoredType, ignored);
+        gotFrame = client.receiveMessage(type, payload);
+        if(!gotFrame)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    CHECK(gotFrame);
+    CHECK(type == MSG_FRAME && payload == big);
+    CHECK(peer.pendingBytes() == 0);
+
+    // messages that arrived before the peer closed are still delivered
+    client.sendMessage(MSG_ACK, &ack, sizeof(ack));
+    client.close();
+    CHECK(receive(peer, type, payload));
+    CHECK(type == MSG_ACK);
+    CHECK(!receive(peer, type, payload));
+    CHECK(!peer.isOpen());
+
+    return true;
+}
+
+static bool testOversizedMessage()
+{
+    Socket server, client, peer;
+    CHECK(connectLoopback(server, client, peer));
+
+    // the receiver gives up on the header alone instead of buffering the announced size
+    std::vector<uint8_t> big(size_t(MAX_MESSAGE_SIZE) + 1);
+    client.sendMessage(MSG_FRAME, big.data(), big.size());
+
+    uint32_t type;
+    std::vector<uint8_t> payload;
+    CHECK(!receive(peer, type, payload));
+    CHECK(!peer.isOpen());
+
+    return true;
+}
+
+int main()
+{
+    bool ok = true;
+    ok = testCodec() && ok;
+    ok = testSocket() && ok;
+    ok = testOversizedMessage() && ok;
+    printf("%s\n", ok ? "all tests passed" : "tests failed");
+    return ok ? 0 : 1;
+}
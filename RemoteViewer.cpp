@@ -0,0 +1,289 @@
+// minimal viewer for ImguiRemoteServer
+// usage: RemoteViewer [host] [port]
+
+#include <SDL.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+
+#include "ImguiRemoteProtocol.h"
+
+using namespace ImguiRemote;
+
+class RemoteViewer
+{
+public:
+    RemoteViewer() : mWindow(NULL), mRenderer(NULL), mFontTex(NULL), mFrameId(0), mFrameBytes(0), mLatencyMs(0)
+    {
+        mDisplaySize[0] = mDisplaySize[1] = 0;
+        mDisplayPos[0] = mDisplayPos[1] = 0;
+    }
+    ~RemoteViewer()
+    {
+        if(mFontTex)
+            SDL_DestroyTexture(mFontTex);
+        if(mRenderer)
+            SDL_DestroyRenderer(mRenderer);
+        if(mWindow)
+            SDL_DestroyWindow(mWindow);
+    }
+
+    bool init(const char* host, uint16_t port)
+    {
+        if(!mSocket.connect(host, port))
+        {
+            fprintf(stderr, "cannot connect to %s:%d\n", host, port);
+            return false;
+        }
+
+        mWindow = SDL_CreateWindow("RemoteViewer", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, 1280, 720,
+                                   SDL_WINDOW_RESIZABLE);
+        mRenderer = SDL_CreateRenderer(mWindow, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
+        return mWindow && mRenderer;
+    }
+
+    void run()
+    {
+        Uint32 statsStart = SDL_GetTicks();
+        uint64_t statsBytes = 0;
+
+        bool quit = false;
+        while(!quit && mSocket.isOpen())
+        {
+            SDL_Event e;
+            while(SDL_PollEvent(&e))
+            {
+                if(e.type == SDL_QUIT)
+                    quit = true;
+                forwardInput(e);
+            }
+
+            bool newFrame = false;
+            uint32_t type;
+            std::vector<uint8_t> payload;
+            while(mSocket.receiveMessage(type, payload))
+            {
+                if(type == MSG_FONT_ATLAS)
+                    receiveFontAtlas(payload);
+                else if(type == MSG_FRAME)
+                    newFrame |= receiveFrame(payload);
+            }
+
+            if(!newFrame)
+            {
+                SDL_Delay(1);
+                continue;
+            }
+
+            render();
+            mSocket.sendMessage(MSG_ACK, &mFrameId, sizeof(mFrameId));
+
+            Uint32 t = SDL_GetTicks();
+            if(t - statsStart >= 1000)
+            {
+                uint64_t received = mSocket.getBytesReceived();
+                char title[128];
+                snprintf(title, sizeof(title), "RemoteViewer - %.1f kB/s, %u bytes/frame, latency %.1f ms",
+                         (received - statsBytes) / 1024.0 * 1000.0 / (t - statsStart), mFrameBytes, mLatencyMs);
+                SDL_SetWindowTitle(mWindow, title);
+                statsStart = t;
+                statsBytes = received;
+            }
+        }
+    }
+
+private:
+    void forwardInput(const SDL_Event& e)
+    {
+        InputEvent evt;
+        memset(&evt, 0, sizeof(evt));
+        switch(e.type)
+        {
+        case SDL_MOUSEMOTION:
+            evt.type = INPUT_MOUSE_MOVE;
+            evt.x = e.motion.x;
+            evt.y = e.motion.y;
+            break;
+        case SDL_MOUSEWHEEL:
+            evt.type = INPUT_MOUSE_WHEEL;
+            evt.y = e.wheel.y;
+            break;
+        case SDL_MOUSEBUTTONDOWN:
+        case SDL_MOUSEBUTTONUP:
+            evt.type = e.type == SDL_MOUSEBUTTONDOWN ? INPUT_MOUSE_DOWN : INPUT_MOUSE_UP;
+            evt.x = e.button.x;
+            evt.y = e.button.y;
+            evt.button = e.button.button;
+            break;
+        case SDL_KEYDOWN:
+        case SDL_KEYUP:
+            evt.type = e.type == SDL_KEYDOWN ? INPUT_KEY_DOWN : INPUT_KEY_UP;
+            evt.scancode = e.key.keysym.scancode;
+            evt.keycode = e.key.keysym.sym;
+            evt.mod = e.key.keysym.mod;
+            break;
+        case SDL_TEXTINPUT:
+            evt.type = INPUT_TEXT;
+            strncpy(evt.text, e.text.text, sizeof(evt.text) - 1);
+            break;
+        default:
+            return;
+        }
+        mSocket.sendMessage(MSG_INPUT, &evt, sizeof(evt));
+    }
+
+    void receiveFontAtlas(const std::vector<uint8_t>& payload)
+    {
+        FontAtlasHeader header;
+        if(payload.size() < sizeof(header))
+            return;
+        memcpy(&header, payload.data(), sizeof(header));
+
+        std::vector<std::vector<uint8_t> > chunks(header.distanceFieldSpread ? 2 : 1);
+        FrameCodec codec;
+        if(!codec.decode(payload, sizeof(header), chunks))
+            return;
+        for(size_t c = 0; c < chunks.size(); c++)
+        {
+            if(chunks[c].size() != header.width * header.height)
+                return;
+        }
+
+        std::vector<Uint32> rgba(chunks[0].size());
+        for(size_t i = 0; i < rgba.size(); i++)
+        {
+            float a = chunks[0][i] / 255.0f;
+            // SDL_Renderer has no shaders, so resolve the glyph distances for 1:1 display
+            if(header.distanceFieldSpread && chunks[1][i])
+                a = std::min(std::max((a - 0.5f) * 2.0f * header.distanceFieldSpread + 0.5f, 0.0f), 1.0f);
+            rgba[i] = (Uint32(a * 255.0f + 0.5f) << 24) | 0x00FFFFFF;
+        }
+
+        if(mFontTex)
+            SDL_DestroyTexture(mFontTex);
+        mFontTex = SDL_CreateTexture(mRenderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STATIC, header.width,
+                                     header.height);
+        SDL_UpdateTexture(mFontTex, NULL, rgba.data(), header.width * 4);
+        SDL_SetTextureBlendMode(mFontTex, SDL_BLENDMODE_BLEND);
+    }
+
+    bool receiveFrame(const std::vector<uint8_t>& payload)
+    {
+        FrameHeader header;
+        if(payload.size() < sizeof(header))
+            return false;
+        memcpy(&header, payload.data(), sizeof(header));
+
+        // every draw list takes at least one byte, so a larger count is corrupt
+        bool valid = header.numDrawLists <= payload.size() - sizeof(header);
+        if(valid)
+            mChunks.resize(header.numDrawLists);
+        if(!valid || !mCodec.decode(payload, sizeof(header), mChunks))
+        {
+            fprintf(stderr, "corrupt frame %u\n", header.frameId);
+            mSocket.close();
+            return false;
+        }
+
+        mDrawLists.resize(header.numDrawLists);
+        for(size_t i = 0; i < mChunks.size(); i++)
+        {
+            if(!deserializeDrawList(mChunks[i], mDrawLists[i]))
+                mDrawLists[i] = DrawList();
+        }
+
+        mFrameId = header.frameId;
+        mFrameBytes = uint32_t(payload.size());
+        mLatencyMs = header.latencyMs;
+        memcpy(mDisplayPos, header.displayPos, sizeof(mDisplayPos));
+        if(mDisplaySize[0] != header.displaySize[0] || mDisplaySize[1] != header.displaySize[1])
+        {
+            // mirror the server window, so input coordinates map 1:1
+            memcpy(mDisplaySize, header.displaySize, sizeof(mDisplaySize));
+            SDL_SetWindowSize(mWindow, int(mDisplaySize[0]), int(mDisplaySize[1]));
+        }
+        return true;
+    }
+
+    void render()
+    {
+        SDL_SetRenderDrawColor(mRenderer, 0, 0, 0, 255);
+        SDL_RenderClear(mRenderer);
+
+        for(size_t l = 0; l < mDrawLists.size(); l++)
+        {
+            const DrawList& list = mDrawLists[l];
+            if(list.vtx.empty())
+                continue;
+
+            const ImDrawVert* vtx = list.vtx.data();
+            size_t idxOffset = 0;
+            for(size_t c = 0; c < list.cmds.size(); c++)
+            {
+                const DrawCmd& cmd = list.cmds[c];
+                if(idxOffset + cmd.elemCount > list.idx.size())
+                    break;
+
+                SDL_Rect clip;
+                clip.x = int(cmd.clipRect[0] - mDisplayPos[0]);
+                clip.y = int(cmd.clipRect[1] - mDisplayPos[1]);
+                clip.w = int(cmd.clipRect[2] - cmd.clipRect[0]);
+                clip.h = int(cmd.clipRect[3] - cmd.clipRect[1]);
+                SDL_RenderSetClipRect(mRenderer, &clip);
+
+                // user textures are not streamed and show up untextured
+                SDL_RenderGeometryRaw(mRenderer, cmd.fontTexture ? mFontTex : NULL,
+                                      &vtx->pos.x, sizeof(ImDrawVert),
+                                      (const SDL_Color*)&vtx->col, sizeof(ImDrawVert),
+                                      &vtx->uv.x, sizeof(ImDrawVert),
+                                      int(list.vtx.size()),
+                                      &list.idx[idxOffset], int(cmd.elemCount), sizeof(ImDrawIdx));
+                idxOffset += cmd.elemCount;
+            }
+        }
+        SDL_RenderSetClipRect(mRenderer, NULL);
+        SDL_RenderPresent(mRenderer);
+    }
+
+    SDL_Window*     mWindow;
+    SDL_Renderer*   mRenderer;
+    SDL_Texture*    mFontTex;
+
+    Socket          mSocket;
+    FrameCodec      mCodec;
+    std::vector<std::vector<uint8_t> > mChunks;
+    std::vector<DrawList> mDrawLists;
+
+    uint32_t        mFrameId;
+    uint32_t        mFrameBytes;
+    float           mLatencyMs;
+    float           mDisplayPos[2];
+    float           mDisplaySize[2];
+};
+
+int main(int argc, char *argv[])
+{
+    const char* host = argc > 1 ? argv[1] : "127.0.0.1";
+    uint16_t port = argc > 2 ? uint16_t(atoi(argv[2])) : DEFAULT_PORT;
+
+    if(SDL_Init(SDL_INIT_VIDEO) != 0)
+    {
+        fprintf(stderr, "SDL_Init failed: %s\n", SDL_GetError());
+        return 1;
+    }
+
+    int ret = 1;
+    {
+        RemoteViewer viewer;
+        if(viewer.init(host, port))
+        {
+            viewer.run();
+            ret = 0;
+        }
+    }
+
+    SDL_Quit();
+    return ret;
+}
@@ -9,6 +9,9 @@ else:
     import Ogre.Bites as OgreBites
 import OgreImgui
 
+import array
+import math
+
 
 class ImguiExample(OgreBites.ApplicationContext, OgreBites.InputListener):
 
@@ -16,6 +19,13 @@ class ImguiExample(OgreBites.ApplicationContext, OgreBites.InputListener):
         OgreBites.ApplicationContext.__init__(self, "OgreImguiExample")
         OgreBites.InputListener.__init__(self)
 
+        # buffers are passed to imgui without copying, numpy float32 arrays work the same
+        self.samples = array.array('f', (math.sin(i * 0.01) for i in range(100000)))
+        self.color = array.array('f', [1, 0.5, 0, 1])
+
+        self.series = OgreImgui.ImguiPlotSeries(1 << 20)
+        self.series.append(self.samples)
+
     def keyPressed(self, evt):
         if evt.keysym.sym == OgreBites.SDLK_ESCAPE:
             self.getRoot().queueEndRendering()
@@ -31,6 +41,10 @@ class ImguiExample(OgreBites.ApplicationContext, OgreBites.InputListener):
 
         OgreImgui.ShowDemoWindow()
 
+        OgreImgui.PlotLines("samples", self.samples)
+        self.series.plot("series")
+        OgreImgui.ColorEdit4("color", self.color)
+
         return True
 
     def setup(self):
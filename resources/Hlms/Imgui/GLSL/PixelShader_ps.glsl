@@ -0,0 +1,54 @@
+#version 330 core
+
+@property( !imgui_rect )
+@property( imgui_tex_array )
+uniform sampler2DArray texMap;
+@else
+uniform sampler2D texMap;
+@end
+@end
+
+in block
+{
+	vec4 colour;
+@property( imgui_rect )
+	vec4 rect;
+	vec2 rectParams;
+	vec4 borderColour;
+@else
+	vec2 uv0;
+@end
+} inPs;
+
+out vec4 outColour;
+
+void main()
+{
+@property( imgui_rect )
+	// signed distance to the rounded rect in pixels
+	vec2 q = abs( inPs.rect.xy ) - inPs.rect.zw + inPs.rectParams.x;
+	float dist = min( max( q.x, q.y ), 0.0 ) + length( max( q, 0.0 ) ) - inPs.rectParams.x;
+	float outer = clamp( 0.5 - dist, 0.0, 1.0 );
+	float inner = clamp( 0.5 - dist - inPs.rectParams.y, 0.0, 1.0 );
+
+	// blend premultiplied, so a transparent fill does not darken the border
+	vec4 fill = vec4( inPs.colour.rgb * inPs.colour.a, inPs.colour.a );
+	vec4 border = vec4( inPs.borderColour.rgb * inPs.borderColour.a, inPs.borderColour.a );
+	vec4 c = mix( border, fill, inner ) * outer;
+	outColour = vec4( c.rgb / max( c.a, 1e-5 ), c.a );
+@else
+@property( imgui_tex_array )
+	vec4 texel = texture( texMap, vec3( inPs.uv0, 0.0 ) );
+@else
+	vec4 texel = texture( texMap, inPs.uv0 );
+@end
+@property( imgui_distance_field )
+	// glyph texels (red = 1) hold the distance to the edge at 0.5. resolve it over one screen pixel.
+	// the custom rects (red = 0) keep their coverage
+	float edgeWidth = max( fwidth( texel.a ), 1e-5 );
+	float coverage = clamp( ( texel.a - 0.5 ) / edgeWidth + 0.5, 0.0, 1.0 );
+	texel = vec4( 1.0, 1.0, 1.0, mix( texel.a, coverage, texel.r ) );
+@end
+	outColour = inPs.colour * texel;
+@end
+}
@@ -0,0 +1,46 @@
+#version 330 core
+
+out gl_PerVertex
+{
+	vec4 gl_Position;
+};
+
+in vec2 vertex;
+in vec4 colour;
+@property( imgui_rect )
+in vec4 uv0; // offset from the rect center, half size
+in vec2 uv1; // rounding, border size
+in vec4 secondary_colour;
+@else
+in vec2 uv0;
+@end
+
+out block
+{
+	vec4 colour;
+@property( imgui_rect )
+	vec4 rect;
+	vec2 rectParams;
+	vec4 borderColour;
+@else
+	vec2 uv0;
+@end
+} outVs;
+
+void main()
+{
+	// positions are already in normalized device coordinates
+@property( imgui_position_range )
+	gl_Position = vec4( vertex.xy * @value( imgui_position_range ).0, 0.0, 1.0 );
+@else
+	gl_Position = vec4( vertex.xy, 0.0, 1.0 );
+@end
+	outVs.colour = colour;
+@property( imgui_rect )
+	outVs.rect = uv0;
+	outVs.rectParams = uv1;
+	outVs.borderColour = secondary_colour;
+@else
+	outVs.uv0 = uv0;
+@end
+}
@@ -0,0 +1,52 @@
+@property( !imgui_rect )
+@property( imgui_tex_array )
+Texture2DArray texMap	: register(t0);
+@else
+Texture2D texMap	: register(t0);
+@end
+SamplerState samplerState	: register(s0);
+@end
+
+struct PS_INPUT
+{
+	float4 colour	: COLOR0;
+@property( imgui_rect )
+	float4 rect			: TEXCOORD0;
+	float2 rectParams	: TEXCOORD1;
+	float4 borderColour	: COLOR1;
+@else
+	float2 uv0		: TEXCOORD0;
+@end
+	float4 gl_Position	: SV_Position;
+};
+
+float4 main( PS_INPUT inPs ) : SV_Target0
+{
+@property( imgui_rect )
+	// signed distance to the rounded rect in pixels
+	float2 q = abs( inPs.rect.xy ) - inPs.rect.zw + inPs.rectParams.x;
+	float dist = min( max( q.x, q.y ), 0.0 ) + length( max( q, 0.0 ) ) - inPs.rectParams.x;
+	float outer = saturate( 0.5 - dist );
+	float inner = saturate( 0.5 - dist - inPs.rectParams.y );
+
+	// blend premultiplied, so a transparent fill does not darken the border
+	float4 fill = float4( inPs.colour.rgb * inPs.colour.a, inPs.colour.a );
+	float4 border = float4( inPs.borderColour.rgb * inPs.borderColour.a, inPs.borderColour.a );
+	float4 c = lerp( border, fill, inner ) * outer;
+	return float4( c.rgb / max( c.a, 1e-5 ), c.a );
+@else
+@property( imgui_tex_array )
+	float4 texel = texMap.Sample( samplerState, float3( inPs.uv0, 0.0 ) );
+@else
+	float4 texel = texMap.Sample( samplerState, inPs.uv0 );
+@end
+@property( imgui_distance_field )
+	// glyph texels (red = 1) hold the distance to the edge at 0.5. resolve it over one screen pixel.
+	// the custom rects (red = 0) keep their coverage
+	float edgeWidth = max( fwidth( texel.a ), 1e-5 );
+	float coverage = saturate( ( texel.a - 0.5 ) / edgeWidth + 0.5 );
+	texel = float4( 1.0, 1.0, 1.0, lerp( texel.a, coverage, texel.r ) );
+@end
+	return inPs.colour * texel;
+@end
+}
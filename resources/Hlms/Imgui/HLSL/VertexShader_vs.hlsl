@@ -0,0 +1,47 @@
+struct VS_INPUT
+{
+	float2 vertex	: POSITION;
+	float4 colour	: COLOR0;
+@property( imgui_rect )
+	float4 uv0		: TEXCOORD0; // offset from the rect center, half size
+	float2 uv1		: TEXCOORD1; // rounding, border size
+	float4 secondary_colour	: COLOR1;
+@else
+	float2 uv0		: TEXCOORD0;
+@end
+};
+
+struct PS_INPUT
+{
+	float4 colour	: COLOR0;
+@property( imgui_rect )
+	float4 rect			: TEXCOORD0;
+	float2 rectParams	: TEXCOORD1;
+	float4 borderColour	: COLOR1;
+@else
+	float2 uv0		: TEXCOORD0;
+@end
+	float4 gl_Position	: SV_Position;
+};
+
+PS_INPUT main( VS_INPUT input )
+{
+	PS_INPUT outVs;
+
+	// positions are already in normalized device coordinates
+@property( imgui_position_range )
+	outVs.gl_Position = float4( input.vertex.xy * @value( imgui_position_range ).0, 0.0, 1.0 );
+@else
+	outVs.gl_Position = float4( input.vertex.xy, 0.0, 1.0 );
+@end
+	outVs.colour = input.colour;
+@property( imgui_rect )
+	outVs.rect = input.uv0;
+	outVs.rectParams = input.uv1;
+	outVs.borderColour = input.secondary_colour;
+@else
+	outVs.uv0 = input.uv0;
+@end
+
+	return outVs;
+}